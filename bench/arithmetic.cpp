@@ -0,0 +1,304 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "curves.hpp"
+
+#include <discrete_logarithm/point_codec.hpp>
+#include <discrete_logarithm/random_points.hpp>
+#include <discrete_logarithm/tonelli_shanks.hpp>
+#include <discrete_logarithm/walk.hpp>
+#include <extended_euclidean/extended_euclidean.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/long_int.hpp>
+
+// every case takes the curve index as range(0) and runs on numbers of its prime's size
+
+// integer operation Op on p and a
+template <class Int, class Op>
+static void IntOp(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    Int x{params.p};
+    Int y{params.a};
+    Op op;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(y);
+        benchmark::DoNotOptimize(op(x, y));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// field operation Op in the default representation of the curve's prime
+template <class Int, class Op>
+static void FieldOp(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    FieldElem<Int> x(Int{params.a});
+    FieldElem<Int> y(Int{params.b});
+    Op op;
+    for (auto _ : state) {
+        x = op(x, y);
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Int>
+static void PointAdd(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> P = GetRandomPoint<Int>();
+    ECPoint<Int> Q = GetRandomPoint<Int>();
+    for (auto _ : state) {
+        P = P + Q;
+        benchmark::DoNotOptimize(P);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Int>
+static void PointDouble(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> P = GetRandomPoint<Int>();
+    for (auto _ : state) {
+        P = P + P;
+        benchmark::DoNotOptimize(P);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// scalar multiplication by a random scalar below the group order
+template <class Int>
+static void PointPower(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> P = GetRandomPoint<Int>();
+    Int n{std::uniform_int_distribution<int64_t>(1, params.q - 1)(bench_gen)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(P.Power(n));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// the same through a comb table of P built outside the timing, as the rho restarts use
+template <class Int>
+static void FixedBasePower(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> P = GetRandomPoint<Int>();
+    FixedBaseComb<Int> comb(P, Int{params.q});
+    Int n{std::uniform_int_distribution<int64_t>(1, params.q - 1)(bench_gen)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(comb.Power(n));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// range(1) terms with random scalars below the group order, as one MultiScalarMul or as a sum
+// of Power() calls
+template <class Int, bool kMulti>
+static void MultiPower(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    std::vector<ECPoint<Int>> points;
+    std::vector<Int> scalars;
+    for (int64_t i = 0; i < state.range(1); ++i) {
+        points.push_back(GetRandomPoint<Int>());
+        scalars.push_back(Int{std::uniform_int_distribution<int64_t>(1, params.q - 1)(bench_gen)});
+    }
+    for (auto _ : state) {
+        if constexpr (kMulti) {
+            benchmark::DoNotOptimize(ECPoint<Int>::MultiScalarMul(points, scalars));
+        } else {
+            ECPoint<Int> sum;
+            for (size_t i = 0; i < points.size(); ++i) {
+                sum += points[i].Power(scalars[i]);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+template <class Int>
+static void ExtendedEuclidean(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    Int a{params.a};
+    Int p{params.p};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ExtendedEuclideanAlgorithm(a, p));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// a^-1 mod p through ModularInverse against the SolveEquation path FieldElem division used before
+template <class Int, bool kDedicated>
+static void Inversion(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    Int a{params.a};
+    Int p{params.p};
+    for (auto _ : state) {
+        if constexpr (kDedicated) {
+            benchmark::DoNotOptimize(ModularInverse(a, p));
+        } else {
+            benchmark::DoNotOptimize(SolveEquation<Int>(Int{1}, a, p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// square root of a^2 modulo p, TonelliShanks sets up a SqrtContext on every call
+template <class Int>
+static void SquareRoot(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    EllipticCurve<Int> ec = SetCurve<Int>(params);
+    FieldElem<Int> root(Int{params.a});
+    Int square = (root * root).GetVal();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(TonelliShanks(square, ec.Prime()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// the same root through one SqrtContext for all iterations
+template <class Int>
+static void ContextSquareRoot(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    PrimeField<Int> field(Int{params.p});
+    SqrtContext<Int> sqrt(field);
+    FieldElem<Int> root(Int{params.a}, field);
+    FieldElem<Int> square = root * root;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sqrt.Sqrt(square));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// range(1) random points of the curve per iteration through RandomPoints
+template <class Int>
+static void RandomPointBatch(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    EllipticCurve<Int> ec(Int{params.a}, Int{params.b}, Int{params.p}, Int{params.q});
+    CurveContext<Int> ctx(ec);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(RandomPoints(ctx, state.range(1), bench_gen));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// 1024 points through PointCodec::EncodeAll or DecodeAll, range(1) is the PointFormat;
+// bytes_per_point is the encoded size next to sizeof(ECPoint<Int>) without its heap limbs
+template <class Int, bool kDecode>
+static void PointCoding(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    auto format = static_cast<PointFormat>(state.range(1));
+    EllipticCurve<Int> ec(Int{params.a}, Int{params.b}, Int{params.p}, Int{params.q});
+    CurveContext<Int> ctx(ec);
+    PointCodec<Int> codec(ctx);
+    std::vector<ECPoint<Int>> points = RandomPoints(ctx, 1024, bench_gen);
+    std::vector<uint8_t> bytes = codec.EncodeAll(points, format);
+    std::vector<ECPoint<Int>> decoded;
+    for (auto _ : state) {
+        if constexpr (kDecode) {
+            decoded.clear();
+            codec.DecodeAll(bytes.data(), points.size(), format, decoded);
+            benchmark::DoNotOptimize(decoded.data());
+        } else {
+            codec.EncodeAll(points, format, bytes.data());
+            benchmark::DoNotOptimize(bytes.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * points.size());
+    state.counters["bytes_per_point"] = static_cast<double>(codec.Size(format));
+    state.counters["object_bytes"] = static_cast<double>(sizeof(ECPoint<Int>));
+}
+
+// one evaluation of the 3-partition iteration function, DiscreteLogarithmFinder::Next
+template <class Int>
+static void WalkNext(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> alpha = GetRandomPoint<Int>();
+    ECPoint<Int> beta = GetRandomPoint<Int>();
+    std::mt19937 gen(42);
+    RhoWalk<ECPoint<Int>, Int> walk(alpha, beta, params.q, WalkOptions::ThreePartition(), gen);
+    WalkTriple<ECPoint<Int>, Int> t{alpha + beta, Int{1}, Int{1}};
+    for (auto _ : state) {
+        t = walk.Next(t);
+        benchmark::DoNotOptimize(t);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void Curves(benchmark::internal::Benchmark* b) {
+    b->DenseRange(0, 2)->ArgName("curve");
+}
+
+static void CurvesAndFormats(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({{0, 1, 2},
+                    {static_cast<int>(PointFormat::kUncompressed),
+                     static_cast<int>(PointFormat::kCompressed)}})
+        ->ArgNames({"curve", "format"});
+}
+
+static void CurvesAndTerms(benchmark::internal::Benchmark* b) {
+    b->ArgsProduct({{0, 1, 2}, {2, 8, 32, 128}})->ArgNames({"curve", "terms"});
+}
+
+BENCHMARK(IntOp<int64_t, std::plus<>>)->Apply(Curves);
+BENCHMARK(IntOp<LongInt, std::plus<>>)->Apply(Curves);
+BENCHMARK(IntOp<int64_t, std::minus<>>)->Apply(Curves);
+BENCHMARK(IntOp<LongInt, std::minus<>>)->Apply(Curves);
+// a product of two numbers of prime size does not fit int64_t
+BENCHMARK(IntOp<LongInt, std::multiplies<>>)->Apply(Curves);
+BENCHMARK(IntOp<int64_t, std::divides<>>)->Apply(Curves);
+BENCHMARK(IntOp<LongInt, std::divides<>>)->Apply(Curves);
+BENCHMARK(IntOp<int64_t, std::modulus<>>)->Apply(Curves);
+BENCHMARK(IntOp<LongInt, std::modulus<>>)->Apply(Curves);
+
+BENCHMARK(FieldOp<int64_t, std::plus<>>)->Apply(Curves);
+BENCHMARK(FieldOp<LongInt, std::plus<>>)->Apply(Curves);
+BENCHMARK(FieldOp<int64_t, std::multiplies<>>)->Apply(Curves);
+BENCHMARK(FieldOp<LongInt, std::multiplies<>>)->Apply(Curves);
+BENCHMARK(FieldOp<int64_t, std::divides<>>)->Apply(Curves);
+BENCHMARK(FieldOp<LongInt, std::divides<>>)->Apply(Curves);
+
+BENCHMARK(PointAdd<int64_t>)->Apply(Curves);
+BENCHMARK(PointAdd<LongInt>)->Apply(Curves);
+BENCHMARK(PointDouble<int64_t>)->Apply(Curves);
+BENCHMARK(PointDouble<LongInt>)->Apply(Curves);
+BENCHMARK(PointPower<int64_t>)->Apply(Curves);
+BENCHMARK(PointPower<LongInt>)->Apply(Curves);
+BENCHMARK(FixedBasePower<int64_t>)->Apply(Curves);
+BENCHMARK(FixedBasePower<LongInt>)->Apply(Curves);
+BENCHMARK(MultiPower<int64_t, true>)->Apply(CurvesAndTerms);
+BENCHMARK(MultiPower<int64_t, false>)->Apply(CurvesAndTerms);
+BENCHMARK(MultiPower<LongInt, true>)->Apply(CurvesAndTerms);
+BENCHMARK(MultiPower<LongInt, false>)->Apply(CurvesAndTerms);
+
+BENCHMARK(ExtendedEuclidean<int64_t>)->Apply(Curves);
+BENCHMARK(ExtendedEuclidean<LongInt>)->Apply(Curves);
+BENCHMARK(Inversion<int64_t, true>)->Apply(Curves);
+BENCHMARK(Inversion<int64_t, false>)->Apply(Curves);
+BENCHMARK(Inversion<FixedInt<2>, true>)->Apply(Curves);
+BENCHMARK(Inversion<FixedInt<2>, false>)->Apply(Curves);
+BENCHMARK(Inversion<LongInt, true>)->Apply(Curves);
+BENCHMARK(Inversion<LongInt, false>)->Apply(Curves);
+BENCHMARK(SquareRoot<int64_t>)->Apply(Curves);
+BENCHMARK(SquareRoot<LongInt>)->Apply(Curves);
+BENCHMARK(ContextSquareRoot<int64_t>)->Apply(Curves);
+BENCHMARK(ContextSquareRoot<FixedInt<2>>)->Apply(Curves);
+BENCHMARK(ContextSquareRoot<LongInt>)->Apply(Curves);
+BENCHMARK(RandomPointBatch<int64_t>)->Apply(CurvesAndTerms);
+BENCHMARK(RandomPointBatch<LongInt>)->Apply(CurvesAndTerms);
+BENCHMARK(PointCoding<int64_t, false>)->Apply(CurvesAndFormats);
+BENCHMARK(PointCoding<int64_t, true>)->Apply(CurvesAndFormats);
+BENCHMARK(PointCoding<LongInt, false>)->Apply(CurvesAndFormats);
+BENCHMARK(PointCoding<LongInt, true>)->Apply(CurvesAndFormats);
+
+BENCHMARK(WalkNext<int64_t>)->Apply(Curves);
+BENCHMARK(WalkNext<LongInt>)->Apply(Curves);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "curves.hpp"
+
+#include <discrete_logarithm/batched_dl_finder.hpp>
+#include <discrete_logarithm/multi_target_finder.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/long_int.hpp>
+
+// range(0) is the curve index, range(1) is the batch size K
+template <class Int>
+static void BatchAdd(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    size_t batch_size = state.range(1);
+    std::vector<ECPoint<Int>> points;
+    std::vector<ECPoint<Int>> addends;
+    for (size_t i = 0; i < batch_size; ++i) {
+        points.push_back(GetRandomPoint<Int>());
+        addends.push_back(GetRandomPoint<Int>());
+    }
+    for (auto _ : state) {
+        ECPoint<Int>::BatchAdd(points, addends);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+// full solve on the 40-bit curve, reports the effective point additions per second
+template <class Int>
+static void BatchedFind(benchmark::State& state) {
+    const CurveParams& params = kCurves[0];
+    SetCurve<Int>(params);
+    ECPoint<Int> P = GetRandomPoint<Int>();
+    ECPoint<Int> Q = GetRandomPoint<Int>();
+    double additions_per_second = 0;
+    for (auto _ : state) {
+        BatchedDiscreteLogarithmFinder<ECPoint<Int>, Int> dl_finder(P, Q, params.q,
+                                                                    state.range(0));
+        benchmark::DoNotOptimize(dl_finder.Find());
+        additions_per_second = dl_finder.AdditionsPerSecond();
+    }
+    state.counters["additions_per_second"] = additions_per_second;
+}
+
+// range(0) targets to the same base on the 40-bit curve through one multi-target finder,
+// additions_per_target falls with the number of targets as about sqrt(2 q / m)
+template <class Int>
+static void MultiTargetFind(benchmark::State& state) {
+    const CurveParams& params = kCurves[0];
+    SetCurve<Int>(params);
+    ECPoint<Int> alpha = GetRandomPoint<Int>();
+    std::vector<ECPoint<Int>> betas;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        betas.push_back(GetRandomPoint<Int>());
+    }
+    double additions_per_target = 0;
+    for (auto _ : state) {
+        MultiTargetDiscreteLogarithmFinder<ECPoint<Int>, Int> dl_finder(alpha, params.q);
+        benchmark::DoNotOptimize(dl_finder.FindAll(betas));
+        additions_per_target = static_cast<double>(dl_finder.Additions()) / betas.size();
+    }
+    state.counters["additions_per_target"] = additions_per_target;
+}
+
+static void BatchSizeArgs(benchmark::internal::Benchmark* b) {
+    for (int curve = 0; curve < 3; ++curve) {
+        for (int batch_size : {1, 4, 16, 64, 256, 1024}) {
+            b->Args({curve, batch_size});
+        }
+    }
+    b->ArgNames({"curve", "K"});
+}
+
+BENCHMARK(BatchAdd<FixedInt<2>>)->Apply(BatchSizeArgs);
+BENCHMARK(BatchAdd<LongInt>)->Apply(BatchSizeArgs);
+BENCHMARK(BatchedFind<FixedInt<2>>)
+    ->ArgName("K")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->Arg(256)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(MultiTargetFind<FixedInt<2>>)
+    ->ArgName("targets")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include <discrete_logarithm/random_points.hpp>
+#include <elliptic_curve/ec_point.hpp>
+#include <elliptic_curve/field.hpp>
+#include <long_arithmetic/long_int.hpp>
+
+// curves from README.md: y^2 = x^3 + ax + b over F_p with prime group order q
+struct CurveParams {
+    int64_t p;
+    int64_t a;
+    int64_t b;
+    int64_t q;
+};
+
+inline constexpr CurveParams kCurves[] = {
+    {1099511627791, 490064540513, 170079681745, 1099513257113},
+    {281474976710677, 187997080572537, 198915293914922, 281474987479363},
+    {72057594037928017, 15222514519776677, 7110318376978981, 72057594089783747},
+};
+
+inline std::mt19937 bench_gen(42);
+
+template <class Int>
+EllipticCurve<Int> SetCurve(const CurveParams& params) {
+    EllipticCurve<Int> ec(Int{params.a}, Int{params.b}, Int{params.p}, Int{params.q});
+    ECPoint<Int>::SetEllipticCurve(ec);
+    return ec;
+}
+
+// a random point of the default curve, which SetCurve sets
+template <class Int>
+ECPoint<Int> GetRandomPoint() {
+    return RandomPoints(ECPoint<Int>().Context(), 1, bench_gen)[0];
+}
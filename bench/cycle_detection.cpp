@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include "curves.hpp"
+
+#include <discrete_logarithm/dl_finder.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+
+// 13-bit prime-order curve from the unit tests, small enough to average over many solves
+inline constexpr CurveParams kSmallCurve = {7727, 149, 449, 7681};
+
+// range(0) is the curve index (3 for kSmallCurve), range(1) is CycleDetection;
+// reports iteration function evaluations per solve
+static void CycleDetectionFind(benchmark::State& state) {
+    const CurveParams& params = state.range(0) < 3 ? kCurves[state.range(0)] : kSmallCurve;
+    SetCurve<FixedInt<2>>(params);
+    auto detection = static_cast<CycleDetection>(state.range(1));
+    uint64_t evaluations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        DiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>> dl_finder(
+            P, Q, params.q, WalkOptions::Adding(20), detection);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dl_finder.Find());
+        evaluations += dl_finder.Evaluations();
+    }
+    state.counters["evaluations_per_solve"] =
+        benchmark::Counter(evaluations, benchmark::Counter::kAvgIterations);
+}
+
+static void DetectionArgs(benchmark::internal::Benchmark* b, int curve) {
+    for (auto detection :
+         {CycleDetection::kFloyd, CycleDetection::kBrent, CycleDetection::kNivasch}) {
+        b->Args({curve, static_cast<int>(detection)});
+    }
+    b->ArgNames({"curve", "detection"});
+}
+
+BENCHMARK(CycleDetectionFind)
+    ->Apply([](auto* b) { DetectionArgs(b, 3); })
+    ->Iterations(1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(CycleDetectionFind)
+    ->Apply([](auto* b) { DetectionArgs(b, 0); })
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
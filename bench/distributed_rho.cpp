@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "curves.hpp"
+
+#include <discrete_logarithm/distributed.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+
+// range(0) is the curve index, range(1) the number of worker processes on localhost,
+// range(2) the DP bits; every iteration solves a fresh random instance
+static void DistributedFind(benchmark::State& state) {
+    using Point = ECPoint<FixedInt<2>>;
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<FixedInt<2>>(params);
+    double points = 0;
+    double seconds = 0;
+    double latency = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Point P = GetRandomPoint<FixedInt<2>>();
+        Point Q = GetRandomPoint<FixedInt<2>>();
+        DistributedCoordinator<Point, FixedInt<2>> coordinator(
+            P, Q, params.q, WalkOptions::Adding(20), state.range(2));
+        std::vector<pid_t> workers;
+        for (int64_t i = 0; i < state.range(1); ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                try {
+                    DistributedWorker<Point, FixedInt<2>>(P, Q, params.q)
+                        .Run("127.0.0.1", coordinator.Port());
+                } catch (const std::runtime_error&) {
+                }
+                _exit(0);
+            }
+            workers.push_back(pid);
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(coordinator.Run());
+        state.PauseTiming();
+        for (pid_t pid : workers) {
+            waitpid(pid, nullptr, 0);
+        }
+        points += coordinator.Stats().points;
+        seconds += coordinator.Stats().seconds;
+        latency += coordinator.Stats().collision_latency;
+        state.ResumeTiming();
+    }
+    state.counters["points_per_sec"] = points / seconds;
+    state.counters["steps_per_sec"] = points * (int64_t{1} << state.range(2)) / seconds;
+    state.counters["collision_latency_ms"] =
+        benchmark::Counter(latency * 1e3 / state.iterations());
+}
+
+static void WorkerScalingArgs(benchmark::internal::Benchmark* b) {
+    int max_workers = std::thread::hardware_concurrency();
+    for (int workers = 1; workers <= max_workers; workers *= 2) {
+        b->Args({0, workers, 8});
+    }
+    b->ArgNames({"curve", "workers", "dp_bits"});
+}
+
+BENCHMARK(DistributedFind)->Apply(WorkerScalingArgs)->Iterations(3)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
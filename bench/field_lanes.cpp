@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "curves.hpp"
+
+#include <elliptic_curve/field_lanes.hpp>
+#include <elliptic_curve/point_lanes.hpp>
+
+// range(0) is the curve index, range(1) the SimdLevel of the lane cases; every iteration runs
+// kLanes independent operations, the scalar cases do them one FieldElem<int64_t> at a time
+static constexpr size_t kLanes = 1024;
+
+static bool SkipUnsupported(benchmark::State& state) {
+    if (static_cast<SimdLevel>(state.range(1)) > DetectSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return true;
+    }
+    return false;
+}
+
+static void LaneMul(benchmark::State& state) {
+    if (SkipUnsupported(state)) {
+        return;
+    }
+    const CurveParams& params = kCurves[state.range(0)];
+    FieldLanes lanes(params.p, static_cast<SimdLevel>(state.range(1)));
+    std::vector<uint64_t> x(kLanes, lanes.ToMont(params.a));
+    std::vector<uint64_t> y(kLanes, lanes.ToMont(params.b));
+    for (auto _ : state) {
+        lanes.Mul(x.data(), y.data(), x.data(), kLanes);
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+static void LaneAdd(benchmark::State& state) {
+    if (SkipUnsupported(state)) {
+        return;
+    }
+    const CurveParams& params = kCurves[state.range(0)];
+    FieldLanes lanes(params.p, static_cast<SimdLevel>(state.range(1)));
+    std::vector<uint64_t> x(kLanes, lanes.ToMont(params.a));
+    std::vector<uint64_t> y(kLanes, lanes.ToMont(params.b));
+    for (auto _ : state) {
+        lanes.Add(x.data(), y.data(), x.data(), kLanes);
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+static void ScalarMul(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    FieldElem<int64_t>::SetPrime(params.p);
+    std::vector<FieldElem<int64_t>> x(kLanes, FieldElem<int64_t>(params.a));
+    std::vector<FieldElem<int64_t>> y(kLanes, FieldElem<int64_t>(params.b));
+    for (auto _ : state) {
+        for (size_t i = 0; i < kLanes; ++i) {
+            x[i] *= y[i];
+        }
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+static void ScalarAdd(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    FieldElem<int64_t>::SetPrime(params.p);
+    std::vector<FieldElem<int64_t>> x(kLanes, FieldElem<int64_t>(params.a));
+    std::vector<FieldElem<int64_t>> y(kLanes, FieldElem<int64_t>(params.b));
+    for (auto _ : state) {
+        for (size_t i = 0; i < kLanes; ++i) {
+            x[i] += y[i];
+        }
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+// kLanes point additions of PointLanes::Add against ECPoint::BatchAdd
+static void LanePointAdd(benchmark::State& state) {
+    if (SkipUnsupported(state)) {
+        return;
+    }
+    const CurveParams& params = kCurves[state.range(0)];
+    EllipticCurve<int64_t> ec = SetCurve<int64_t>(params);
+    CurveContext<int64_t> ctx(ec);
+    std::vector<ECPoint<int64_t>> points;
+    std::vector<ECPoint<int64_t>> addends;
+    for (size_t i = 0; i < kLanes; ++i) {
+        points.push_back(GetRandomPoint<int64_t>());
+        addends.push_back(GetRandomPoint<int64_t>());
+    }
+    PointLanes lanes(ctx, static_cast<SimdLevel>(state.range(1)));
+    PointLanes lane_addends(ctx, static_cast<SimdLevel>(state.range(1)));
+    lanes.Assign(points);
+    lane_addends.Assign(addends);
+    for (auto _ : state) {
+        lanes.Add(lane_addends);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+static void ScalarPointAdd(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<int64_t>(params);
+    std::vector<ECPoint<int64_t>> points;
+    std::vector<ECPoint<int64_t>> addends;
+    for (size_t i = 0; i < kLanes; ++i) {
+        points.push_back(GetRandomPoint<int64_t>());
+        addends.push_back(GetRandomPoint<int64_t>());
+    }
+    for (auto _ : state) {
+        ECPoint<int64_t>::BatchAdd(points, addends);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kLanes);
+}
+
+static void LaneArgs(benchmark::internal::Benchmark* b) {
+    for (int curve = 0; curve < 3; ++curve) {
+        for (auto level : {SimdLevel::kScalar, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+            b->Args({curve, static_cast<int>(level)});
+        }
+    }
+    b->ArgNames({"curve", "level"});
+}
+
+static void ScalarArgs(benchmark::internal::Benchmark* b) {
+    b->DenseRange(0, 2)->ArgName("curve");
+}
+
+BENCHMARK(LaneMul)->Apply(LaneArgs);
+BENCHMARK(ScalarMul)->Apply(ScalarArgs);
+BENCHMARK(LaneAdd)->Apply(LaneArgs);
+BENCHMARK(ScalarAdd)->Apply(ScalarArgs);
+BENCHMARK(LanePointAdd)->Apply(LaneArgs);
+BENCHMARK(ScalarPointAdd)->Apply(ScalarArgs);
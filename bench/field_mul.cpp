@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "curves.hpp"
+
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/long_int.hpp>
+
+// range(0) is the curve index, range(1) is FieldRepr
+template <class Int>
+static void FieldMul(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    FieldElem<Int>::SetPrime(Int{params.p}, static_cast<FieldRepr>(state.range(1)));
+    FieldElem<Int> x(Int{params.a});
+    FieldElem<Int> y(Int{params.b});
+    for (auto _ : state) {
+        x *= y;
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void FieldReprArgs(benchmark::internal::Benchmark* b) {
+    for (int curve = 0; curve < 3; ++curve) {
+        b->Args({curve, static_cast<int>(FieldRepr::kPlain)});
+        b->Args({curve, static_cast<int>(FieldRepr::kMontgomery)});
+    }
+    b->ArgNames({"curve", "repr"});
+}
+
+// the plain int64_t path overflows on these primes, so only its Montgomery form is measured
+BENCHMARK(FieldMul<int64_t>)
+    ->Args({0, static_cast<int>(FieldRepr::kMontgomery)})
+    ->Args({1, static_cast<int>(FieldRepr::kMontgomery)})
+    ->Args({2, static_cast<int>(FieldRepr::kMontgomery)})
+    ->ArgNames({"curve", "repr"});
+BENCHMARK(FieldMul<FixedInt<2>>)->Apply(FieldReprArgs);
+BENCHMARK(FieldMul<FixedInt<4>>)->Apply(FieldReprArgs);
+BENCHMARK(FieldMul<LongInt>)->Apply(FieldReprArgs);
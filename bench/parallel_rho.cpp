@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+#include "curves.hpp"
+
+#include <discrete_logarithm/dl_finder.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+
+// range(0) is the curve index, range(1) the number of threads, range(2) the DP bits;
+// every iteration solves a fresh random instance. linear speedup shows as a flat
+// evaluations_per_second_per_thread and evaluations_per_solve over the thread count
+static void ParallelFind(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<FixedInt<2>>(params);
+    double evaluations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        DiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>> dl_finder(
+            P, Q, params.q, WalkOptions::Adding(20));
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dl_finder.ParallelFind(state.range(1), state.range(2)));
+        evaluations += dl_finder.Evaluations();
+    }
+    state.counters["evaluations_per_second"] =
+        benchmark::Counter(evaluations, benchmark::Counter::kIsRate);
+    state.counters["evaluations_per_second_per_thread"] =
+        benchmark::Counter(evaluations / state.range(1), benchmark::Counter::kIsRate);
+    state.counters["evaluations_per_solve"] =
+        benchmark::Counter(evaluations, benchmark::Counter::kAvgIterations);
+}
+
+static void ThreadScalingArgs(benchmark::internal::Benchmark* b) {
+    int max_threads = std::thread::hardware_concurrency();
+    for (int curve = 0; curve < 3; ++curve) {
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            b->Args({curve, threads, 4 + 2 * curve});
+        }
+    }
+    b->ArgNames({"curve", "threads", "dp_bits"});
+}
+
+static void DistinguishedRateArgs(benchmark::internal::Benchmark* b) {
+    int max_threads = std::thread::hardware_concurrency();
+    for (int dp_bits = 0; dp_bits <= 12; dp_bits += 2) {
+        b->Args({0, max_threads, dp_bits});
+    }
+    b->ArgNames({"curve", "threads", "dp_bits"});
+}
+
+BENCHMARK(ParallelFind)->Apply(ThreadScalingArgs)->Iterations(5)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
+BENCHMARK(ParallelFind)->Apply(DistinguishedRateArgs)->Iterations(5)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
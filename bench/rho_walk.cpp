@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+#include "curves.hpp"
+
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/long_int.hpp>
+
+// one step of the 3-partition walk used by DiscreteLogarithmFinder::Next
+template <class Int>
+static void RhoWalk(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> alpha = GetRandomPoint<Int>();
+    ECPoint<Int> beta = GetRandomPoint<Int>();
+    Int order{params.q};
+
+    ECPoint<Int> x = alpha + beta;
+    Int a = 1;
+    Int b = 1;
+    for (auto _ : state) {
+        std::size_t part = x.Partition(3, 0).index;
+        if (part == 0) {
+            x = x + beta;
+            b = (b + Int{1}) % order;
+        } else if (part == 1) {
+            x = x + x;
+            a = (a * Int{2}) % order;
+            b = (b * Int{2}) % order;
+        } else {
+            x = x + alpha;
+            a = (a + Int{1}) % order;
+        }
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// cost of classifying a point: Partition() reads one limb of x, std::hash covers x and y
+template <class Int>
+static void PointClassify(benchmark::State& state) {
+    const CurveParams& params = kCurves[state.range(0)];
+    SetCurve<Int>(params);
+    ECPoint<Int> x = GetRandomPoint<Int>();
+    bool full_hash = state.range(1);
+    auto hash = std::hash<ECPoint<Int>>{};
+    for (auto _ : state) {
+        if (full_hash) {
+            benchmark::DoNotOptimize(hash(x));
+        } else {
+            benchmark::DoNotOptimize(x.Partition(20, 8));
+        }
+    }
+    state.SetLabel(full_hash ? "hash" : "partition");
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(RhoWalk<LongInt>)->DenseRange(0, 2);
+BENCHMARK(RhoWalk<FixedInt<2>>)->DenseRange(0, 2);
+BENCHMARK(RhoWalk<FixedInt<4>>)->DenseRange(0, 2);
+BENCHMARK(PointClassify<LongInt>)->ArgsProduct({{0, 1, 2}, {0, 1}});
+BENCHMARK(PointClassify<FixedInt<4>>)->ArgsProduct({{0, 1, 2}, {0, 1}});
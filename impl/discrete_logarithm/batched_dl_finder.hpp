@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <discrete_logarithm/dp_table.hpp>
+#include <discrete_logarithm/walk.hpp>
+
+// GroupElem requires operator+(), operator==(), std::hash, Power() and
+// static BatchAdd(std::vector<GroupElem>& points, const std::vector<GroupElem>& addends)
+
+// advances batch_size independent walks in lockstep so that every step of all walks costs
+// a single BatchAdd; walks report distinguished points (dp_bits zero bits above the
+// partition) to a shared table and keep going, the first collision with a different
+// (a, b) is solved
+template <class GroupElem, class Int>
+class BatchedDiscreteLogarithmFinder {
+public:
+    BatchedDiscreteLogarithmFinder(GroupElem alpha, GroupElem beta, int64_t order,
+                                   size_t batch_size, int dp_bits = -1,
+                                   WalkOptions walk = WalkOptions::ThreePartition())
+        : alpha_{alpha},
+          beta_{beta},
+          group_order_{order},
+          init_order_{order},
+          alpha_powers_{alpha, Int{order}},
+          beta_powers_{beta, Int{order}},
+          batch_size_{batch_size},
+          dp_bits_{dp_bits < 0 ? DefaultDistinguishedBits(order) : dp_bits},
+          gen_{seed_++},
+          walk_{alpha, beta, order, walk, gen_} {
+    }
+
+    Int Find() {
+        auto start = std::chrono::steady_clock::now();
+        additions_ = 0;
+
+        DistinguishedPointTable<GroupElem, Int> table;
+        std::vector<GroupElem> x(batch_size_);
+        std::vector<Int> a(batch_size_);
+        std::vector<Int> b(batch_size_);
+        std::vector<int64_t> length(batch_size_, 0);
+        std::vector<WalkPartition> part(batch_size_);
+        std::vector<TwoCycleGuard<GroupElem, Int>> guards(batch_size_);
+        BatchStepBuffers<GroupElem, Int> buffers;
+        for (size_t i = 0; i < batch_size_; ++i) {
+            Restart(x[i], a[i], b[i], part[i]);
+        }
+
+        const int64_t max_length = MaxWalkLength(dp_bits_);
+        while (true) {
+            additions_ += walk_.BatchStep(x, a, b, part, dp_bits_, buffers);
+
+            for (size_t i = 0; i < batch_size_; ++i) {
+                // 2-cycles left once BatchStep() tried every slot
+                if (walk_.NegationMap() && guards[i].Check(walk_, x[i], a[i], b[i])) {
+                    part[i] = walk_.Classify(x[i], dp_bits_);
+                    ++additions_;
+                }
+                ++length[i];
+                if (!part[i].distinguished) {
+                    if (length[i] > max_length) {
+                        Restart(x[i], a[i], b[i], part[i]);
+                        length[i] = 0;
+                    }
+                    continue;
+                }
+                length[i] = 0;
+                auto prev = table.Insert({x[i], a[i], b[i]});
+                if (!prev) {
+                    continue;
+                }
+                auto res = SolveCollision(a[i], b[i], prev->first, prev->second, group_order_);
+                // with a composite order SolveCollision() picks one of several solutions, so the
+                // answer is checked
+                if (res && alpha_.Power(*res) == beta_) {
+                    elapsed_ = std::chrono::steady_clock::now() - start;
+                    return *res;
+                }
+                // merged into a walk with the same coefficients or into a wrong answer, it would
+                // only repeat that walk
+                Restart(x[i], a[i], b[i], part[i]);
+            }
+        }
+    }
+
+    // group additions performed by the last Find(), including doublings
+    uint64_t Additions() const {
+        return additions_;
+    }
+
+    double AdditionsPerSecond() const {
+        return elapsed_.count() > 0 ? additions_ / elapsed_.count() : 0;
+    }
+
+private:
+    // every finder draws from its own generator so that finders can run in different threads
+    static std::atomic<uint32_t> seed_;
+
+    void Restart(GroupElem& x, Int& a, Int& b, WalkPartition& part) {
+        std::uniform_int_distribution<int64_t> dist(0, init_order_ - 1);
+        a = Int{dist(gen_)};
+        b = Int{dist(gen_)};
+        x = alpha_powers_.Power(a) + beta_powers_.Power(b);
+        part = walk_.Classify(x, dp_bits_);
+    }
+
+    GroupElem alpha_;
+    GroupElem beta_;
+    Int group_order_;
+    int64_t init_order_;
+    typename FixedBaseOf<GroupElem, Int>::type alpha_powers_;
+    typename FixedBaseOf<GroupElem, Int>::type beta_powers_;
+    size_t batch_size_;
+    int dp_bits_;
+    std::mt19937 gen_;
+    RhoWalk<GroupElem, Int> walk_;
+
+    uint64_t additions_ = 0;
+    std::chrono::duration<double> elapsed_{0};
+};
+
+template <class GroupElem, class Int>
+std::atomic<uint32_t> BatchedDiscreteLogarithmFinder<GroupElem, Int>::seed_(42);
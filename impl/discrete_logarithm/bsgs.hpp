@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <discrete_logarithm/dl_finder.hpp>
+#include <discrete_logarithm/walk.hpp>
+
+// GroupElem requires operator+(), operator==(), std::hash, Power()
+
+inline int64_t CeilSqrt(int64_t n) {
+    int64_t r = static_cast<int64_t>(std::sqrt(static_cast<double>(n)));
+    while (r * r < n) {
+        ++r;
+    }
+    while (r > 0 && (r - 1) * (r - 1) >= n) {
+        --r;
+    }
+    return r;
+}
+
+// open-addressing table from 32-bit fingerprints of std::hash to baby-step indices,
+// 8-byte slots, a power-of-two capacity and load factor at most 1/2;
+// a fingerprint match is only a candidate
+class BabyStepTable {
+public:
+    explicit BabyStepTable(size_t entries) {
+        size_t capacity = Capacity(entries);
+        shift_ = 64;
+        for (size_t c = capacity; c > 1; c /= 2) {
+            --shift_;
+        }
+        slots_.assign(capacity, Slot{0, kEmpty});
+    }
+
+    static size_t Bytes(size_t entries) {
+        return Capacity(entries) * sizeof(Slot);
+    }
+
+    // the most entries a table of at most bytes bytes holds
+    static size_t MaxEntries(size_t bytes) {
+        size_t capacity = 2;
+        while (2 * capacity * sizeof(Slot) <= bytes) {
+            capacity *= 2;
+        }
+        return capacity / 2;
+    }
+
+    void Insert(size_t hash, uint32_t index) {
+        uint64_t mixed = Mix(hash);
+        size_t i = Home(mixed);
+        while (slots_[i].index != kEmpty) {
+            i = (i + 1) & (slots_.size() - 1);
+        }
+        slots_[i] = Slot{static_cast<uint32_t>(mixed), index};
+    }
+
+    // calls on_candidate(index) for every stored index with the fingerprint of hash
+    // until it returns true, returns whether it did
+    template <class Callback>
+    bool Lookup(size_t hash, Callback on_candidate) const {
+        uint64_t mixed = Mix(hash);
+        uint32_t key = static_cast<uint32_t>(mixed);
+        for (size_t i = Home(mixed); slots_[i].index != kEmpty; i = (i + 1) & (slots_.size() - 1)) {
+            if (slots_[i].key == key && on_candidate(slots_[i].index)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr uint32_t kEmpty = ~uint32_t{0};
+
+    struct Slot {
+        uint32_t key;
+        uint32_t index;
+    };
+
+    static size_t Capacity(size_t entries) {
+        size_t capacity = 2;
+        while (capacity < 2 * entries) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Fibonacci hashing spreads weak hashes (identity on small integers) over the high bits
+    static uint64_t Mix(size_t hash) {
+        return static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    }
+
+    size_t Home(uint64_t mixed) const {
+        return static_cast<size_t>(mixed >> shift_);
+    }
+
+    int shift_;
+    std::vector<Slot> slots_;
+};
+
+// holds the full table of orders up to 2^40
+constexpr size_t kDefaultBabyStepBudget = size_t{16} << 20;
+
+// deterministic baby-step giant-step: alpha^(i*m + j) = beta for baby steps j < m and giant
+// steps i, m = ceil(sqrt(order)) unless memory_budget bytes allow fewer baby steps, then the
+// giant steps grow to order / m
+template <class GroupElem, class Int>
+class BabyStepGiantStep {
+public:
+    BabyStepGiantStep(GroupElem alpha, GroupElem beta, int64_t order,
+                      size_t memory_budget = kDefaultBabyStepBudget)
+        : alpha_{alpha}, beta_{beta}, order_{order} {
+        int64_t max_steps = static_cast<int64_t>(BabyStepTable::MaxEntries(memory_budget));
+        baby_steps_ = std::min({CeilSqrt(order), max_steps, int64_t{~uint32_t{0} - 1}});
+    }
+
+    // logarithm in [0, order), -1 if beta is not a power of alpha
+    Int Find() const {
+        auto hash = std::hash<GroupElem>{};
+        BabyStepTable table(baby_steps_);
+        GroupElem cur = alpha_.Power(Int{0});
+        for (int64_t j = 0; j < baby_steps_; ++j) {
+            table.Insert(hash(cur), static_cast<uint32_t>(j));
+            cur = cur + alpha_;
+        }
+
+        // alpha^-m
+        GroupElem giant = alpha_.Power(Int{(order_ - baby_steps_ % order_) % order_});
+        cur = beta_;
+        int64_t res = -1;
+        for (int64_t i = 0; i * baby_steps_ < order_; ++i) {
+            bool found = table.Lookup(hash(cur), [&](uint32_t j) {
+                int64_t x = (i * baby_steps_ + j) % order_;
+                if (!(alpha_.Power(Int{x}) == beta_)) {
+                    return false;
+                }
+                res = x;
+                return true;
+            });
+            if (found) {
+                break;
+            }
+            cur = cur + giant;
+        }
+        return Int{res};
+    }
+
+    int64_t BabySteps() const {
+        return baby_steps_;
+    }
+
+private:
+    GroupElem alpha_;
+    GroupElem beta_;
+    int64_t order_;
+    int64_t baby_steps_;
+};
+
+enum class DiscreteLogarithmMethod { kBabyStepGiantStep, kRho };
+
+// BSGS when the full baby-step table fits into memory_budget: it then costs 2 sqrt(order)
+// group operations deterministically, against about 1.25 sqrt(order) expected for rho
+// plus its variance and restarts
+inline DiscreteLogarithmMethod ChooseDiscreteLogarithmMethod(int64_t order,
+                                                             size_t memory_budget) {
+    if (BabyStepTable::Bytes(CeilSqrt(order)) <= memory_budget) {
+        return DiscreteLogarithmMethod::kBabyStepGiantStep;
+    }
+    return DiscreteLogarithmMethod::kRho;
+}
+
+template <class GroupElem, class Int>
+Int SolveDiscreteLogarithm(const GroupElem& alpha, const GroupElem& beta, int64_t order,
+                           size_t memory_budget = kDefaultBabyStepBudget,
+                           WalkOptions walk = WalkOptions::ThreePartition()) {
+    if (ChooseDiscreteLogarithmMethod(order, memory_budget) ==
+        DiscreteLogarithmMethod::kBabyStepGiantStep) {
+        return BabyStepGiantStep<GroupElem, Int>(alpha, beta, order, memory_budget).Find();
+    }
+    return DiscreteLogarithmFinder<GroupElem, Int>(alpha, beta, order, walk).Find();
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <poll.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <discrete_logarithm/dl_finder.hpp>
+#include <discrete_logarithm/dp_protocol.hpp>
+#include <discrete_logarithm/dp_table.hpp>
+#include <discrete_logarithm/walk.hpp>
+
+// GroupElem requires operator+(), operator==(), std::hash, Power()
+
+struct CoordinatorStats {
+    size_t workers = 0;
+    uint64_t points = 0;
+    uint64_t batches = 0;
+    double seconds = 0;  // from the first worker to the solution
+    // from the worker finding the first point of the batch that collided to the solution
+    double collision_latency = 0;
+
+    double PointsPerSecond() const {
+        return seconds > 0 ? static_cast<double>(points) / seconds : 0;
+    }
+};
+
+// owns the distinguished-point table of a rho spread over processes or machines: workers
+// connect over TCP, get the problem and the iteration function and stream batches of
+// distinguished points back until a collision between two of them solves the logarithm
+template <class GroupElem, class Int>
+class DistributedCoordinator {
+public:
+    // listens on address:port right away so workers can connect before Run(), port 0 picks a
+    // free one; throws std::runtime_error
+    DistributedCoordinator(GroupElem alpha, GroupElem beta, int64_t order,
+                           WalkOptions walk = WalkOptions::ThreePartition(), int dp_bits = -1,
+                           const std::string& address = "127.0.0.1", uint16_t port = 0)
+        : alpha_{alpha},
+          beta_{beta},
+          order_{order},
+          walk_{walk},
+          dp_bits_{dp_bits < 0 ? DefaultDistinguishedBits(order) : dp_bits} {
+        listen_fd_ = ListenSocket(address, port);
+        port_ = port;
+    }
+
+    ~DistributedCoordinator() {
+        CloseSocket(listen_fd_);
+    }
+
+    DistributedCoordinator(const DistributedCoordinator&) = delete;
+    DistributedCoordinator& operator=(const DistributedCoordinator&) = delete;
+
+    uint16_t Port() const {
+        return port_;
+    }
+
+    // serves workers until the logarithm is found and tells them to stop,
+    // -1 if every worker left before that
+    Int Run() {
+        stats_ = {};
+        std::unordered_map<uint64_t, std::pair<int64_t, int64_t>> table;
+        std::vector<pollfd> fds{{listen_fd_, POLLIN, 0}};
+        std::vector<char> payload;
+        int64_t start = 0;
+        std::optional<Int> res;
+        while (!res && (stats_.workers == 0 || fds.size() > 1)) {
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                continue;
+            }
+            for (size_t i = 1; i < fds.size() && !res; ++i) {
+                if (!fds[i].revents) {
+                    continue;
+                }
+                DistributedMessage type;
+                if (ReceiveFrame(fds[i].fd, type, payload) && type == DistributedMessage::kBatch &&
+                    payload.size() >= sizeof(BatchHeader)) {
+                    res = Consume(payload, table);
+                    continue;
+                }
+                CloseSocket(fds[i].fd);
+                fds[i].fd = -1;
+            }
+            if (!res && (fds[0].revents & POLLIN)) {
+                Accept(fds);
+                if (start == 0) {
+                    start = SteadyNanoseconds();
+                }
+            }
+            fds.erase(std::remove_if(fds.begin() + 1, fds.end(),
+                                     [](const pollfd& p) { return p.fd < 0; }),
+                      fds.end());
+        }
+        stats_.seconds = static_cast<double>(SteadyNanoseconds() - start) * 1e-9;
+        for (size_t i = 1; i < fds.size(); ++i) {
+            SendFrame(fds[i].fd, DistributedMessage::kStop, nullptr, 0);
+            CloseSocket(fds[i].fd);
+        }
+        return res ? *res : Int{-1};
+    }
+
+    // of the last Run()
+    const CoordinatorStats& Stats() const {
+        return stats_;
+    }
+
+private:
+    void Accept(std::vector<pollfd>& fds) {
+        int fd = AcceptSocket(listen_fd_);
+        if (fd < 0) {
+            return;
+        }
+        auto hash = std::hash<GroupElem>{};
+        JobMessage job{order_,
+                       hash(alpha_),
+                       hash(beta_),
+                       dp_bits_,
+                       walk_.adding_slots,
+                       walk_.doubling_slots,
+                       walk_.pollard,
+                       walk_.negation_map,
+                       walk_.beta_independent,
+                       0,
+                       walk_seed_,
+                       static_cast<uint32_t>(gen_())};
+        if (!SendFrame(fd, DistributedMessage::kJob, &job, sizeof(job))) {
+            CloseSocket(fd);
+            return;
+        }
+        fds.push_back({fd, POLLIN, 0});
+        ++stats_.workers;
+    }
+
+    // a batch of distinguished points, the solution if one of them collides usefully
+    std::optional<Int> Consume(const std::vector<char>& payload,
+                               std::unordered_map<uint64_t, std::pair<int64_t, int64_t>>& table) {
+        BatchHeader header;
+        std::memcpy(&header, payload.data(), sizeof(header));
+        size_t count = (payload.size() - sizeof(header)) / sizeof(DistinguishedPointRecord);
+        ++stats_.batches;
+        stats_.points += count;
+        for (size_t i = 0; i < count; ++i) {
+            DistinguishedPointRecord r;
+            std::memcpy(&r, payload.data() + sizeof(header) + i * sizeof(r), sizeof(r));
+            auto [it, inserted] = table.emplace(r.fingerprint, std::make_pair(r.a, r.b));
+            if (inserted) {
+                continue;
+            }
+            // fingerprints may collide, the answer is checked
+            auto res = SolveCollision(Int{r.a}, Int{r.b}, Int{it->second.first},
+                                      Int{it->second.second}, Int{order_});
+            if (res && alpha_.Power(*res) == beta_) {
+                stats_.collision_latency =
+                    static_cast<double>(SteadyNanoseconds() - header.first_point_ns) * 1e-9;
+                return res;
+            }
+        }
+        return std::nullopt;
+    }
+
+    GroupElem alpha_;
+    GroupElem beta_;
+    int64_t order_;
+    WalkOptions walk_;
+    int dp_bits_;
+    std::mt19937 gen_{42};
+    uint32_t walk_seed_ = static_cast<uint32_t>(gen_());
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    CoordinatorStats stats_;
+};
+
+// one process of a distributed rho: walks the problem it gets from the coordinator in
+// num_threads threads and sends the distinguished points in batches of batch_size (at most
+// kMaxBatchPoints), or fewer once the first point of a batch waited flush_interval
+template <class GroupElem, class Int>
+class DistributedWorker {
+public:
+    DistributedWorker(GroupElem alpha, GroupElem beta, int64_t order)
+        : alpha_{alpha}, beta_{beta}, order_{order} {
+    }
+
+    // runs until the coordinator stops it or goes away and returns the number of points sent,
+    // 0 if the coordinator works on another problem; throws std::runtime_error if it cannot
+    // connect
+    uint64_t Run(const std::string& address, uint16_t port, size_t num_threads = 1,
+                 size_t batch_size = 256,
+                 std::chrono::milliseconds flush_interval = std::chrono::milliseconds(50)) const {
+        int fd = ConnectSocket(address, port);
+        DistributedMessage type;
+        std::vector<char> payload;
+        JobMessage job;
+        auto hash = std::hash<GroupElem>{};
+        if (!ReceiveFrame(fd, type, payload) || type != DistributedMessage::kJob ||
+            payload.size() != sizeof(job)) {
+            CloseSocket(fd);
+            return 0;
+        }
+        std::memcpy(&job, payload.data(), sizeof(job));
+        if (job.order != order_ || job.alpha_hash != hash(alpha_) ||
+            job.beta_hash != hash(beta_)) {
+            CloseSocket(fd);
+            return 0;
+        }
+
+        std::atomic<bool> done{false};
+        std::thread reader([fd, &done] {
+            DistributedMessage type;
+            std::vector<char> payload;
+            while (ReceiveFrame(fd, type, payload) && type != DistributedMessage::kStop) {
+            }
+            done = true;
+        });
+        BatchSender sender(fd, batch_size,
+                           std::chrono::nanoseconds(flush_interval).count(), done);
+        // sends batches that waited flush_interval even when the walks find no new points
+        std::thread flusher([&sender] { sender.FlushLoop(); });
+        WalkOptions walk{job.adding_slots, job.doubling_slots, job.pollard != 0,
+                         job.negation_map != 0, job.beta_independent != 0};
+        DiscreteLogarithmFinder<GroupElem, Int> finder(alpha_, beta_, order_, walk);
+        finder.RunWalks(sender, job.walk_seed, job.start_seed, num_threads, job.dp_bits, done);
+        sender.Close();
+        flusher.join();
+        ShutdownSocket(fd);
+        reader.join();
+        CloseSocket(fd);
+        return sender.Sent();
+    }
+
+private:
+    // distinguished-point table of the walks that forwards everything to the coordinator
+    class BatchSender {
+    public:
+        BatchSender(int fd, size_t batch_size, int64_t flush_ns, std::atomic<bool>& done)
+            : fd_{fd},
+              batch_size_{std::clamp<size_t>(batch_size, 1, kMaxBatchPoints)},
+              flush_ns_{flush_ns},
+              done_{done} {
+            batch_.reserve(sizeof(BatchHeader) + batch_size_ * sizeof(DistinguishedPointRecord));
+        }
+
+        std::optional<std::pair<Int, Int>> Insert(const WalkTriple<GroupElem, Int>& t) {
+            DistinguishedPointRecord r{std::hash<GroupElem>{}(t.x), NarrowToInt64(t.a),
+                                       NarrowToInt64(t.b)};
+            int64_t now = SteadyNanoseconds();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (batch_.empty()) {
+                BatchHeader header{now};
+                batch_.resize(sizeof(header));
+                std::memcpy(batch_.data(), &header, sizeof(header));
+                first_point_ns_ = now;
+                // FlushLoop() sleeps until a batch starts
+                wake_.notify_one();
+            }
+            const char* bytes = reinterpret_cast<const char*>(&r);
+            batch_.insert(batch_.end(), bytes, bytes + sizeof(r));
+            ++points_;
+            if (points_ >= batch_size_ || now - first_point_ns_ >= flush_ns_) {
+                Send();
+            }
+            return std::nullopt;
+        }
+
+        // sends the batch once its first point waited flush_ns, until Close()
+        void FlushLoop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!closed_) {
+                if (points_ == 0) {
+                    wake_.wait(lock);
+                    continue;
+                }
+                int64_t wait = first_point_ns_ + flush_ns_ - SteadyNanoseconds();
+                if (wait <= 0) {
+                    Send();
+                    continue;
+                }
+                wake_.wait_for(lock, std::chrono::nanoseconds(wait));
+            }
+        }
+
+        // sends what is left and stops FlushLoop()
+        void Close() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (points_ > 0) {
+                Send();
+            }
+            closed_ = true;
+            wake_.notify_one();
+        }
+
+        uint64_t Sent() const {
+            return sent_;
+        }
+
+    private:
+        // with mutex_ held
+        void Send() {
+            if (!SendFrame(fd_, DistributedMessage::kBatch, batch_.data(), batch_.size())) {
+                done_ = true;
+            }
+            sent_ += points_;
+            points_ = 0;
+            batch_.clear();
+        }
+
+        int fd_;
+        size_t batch_size_;
+        int64_t flush_ns_;
+        std::atomic<bool>& done_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::vector<char> batch_;
+        int64_t first_point_ns_ = 0;
+        size_t points_ = 0;
+        uint64_t sent_ = 0;
+        bool closed_ = false;
+    };
+
+    GroupElem alpha_;
+    GroupElem beta_;
+    int64_t order_;
+};
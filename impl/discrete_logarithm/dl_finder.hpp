@@ -1,76 +1,521 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <discrete_logarithm/dp_store.hpp>
+#include <discrete_logarithm/dp_table.hpp>
+#include <discrete_logarithm/stop_token.hpp>
+#include <discrete_logarithm/walk.hpp>
 #include <extended_euclidean/extended_euclidean.hpp>
 
 // GroupElem requires operator+(), operator==(), std::hash, Power()
 
+// how the single-walk Find() detects that the walk entered a cycle:
+// kFloyd evaluates the iteration function three times per step,
+// kBrent teleports the tortoise at powers of two and evaluates it once per step,
+// kNivasch keeps a stack of hash minima and stops at the second visit of the cycle minimum
+enum class CycleDetection { kFloyd, kBrent, kNivasch };
+
+// progress of a running Find()
+struct FinderStats {
+    uint64_t steps = 0;  // evaluations of the iteration function
+    uint64_t additions = 0;
+    uint64_t doublings = 0;
+    uint64_t inversions = 0;  // field inversions, for groups that declare kInversionsPerAdd
+    uint64_t restarts = 0;    // collisions with b = b' that said nothing about the logarithm
+    double seconds = 0;
+    // sqrt(pi * q / 2), the mean rho length of a random map, sqrt(pi * q / 4) under the
+    // negation map
+    double expected_steps = 0;
+
+    // seconds until expected_steps at the current rate, 0 once past them
+    double Eta() const {
+        if (steps == 0 || static_cast<double>(steps) >= expected_steps) {
+            return 0;
+        }
+        return (expected_steps - static_cast<double>(steps)) * seconds /
+               static_cast<double>(steps);
+    }
+};
+
+// called with the stats of a running Find()
+using FinderObserver = std::function<void(const FinderStats&)>;
+
+enum class FindStatus { kSolved, kCancelled, kTimedOut };
+
+// outcome of FindAsync(): the logarithm if solved, the progress made until the stop otherwise
+template <class Int>
+struct FindResult {
+    FindStatus status;
+    Int logarithm;
+    FinderStats stats;
+};
+
+// order is the order of alpha and must be prime for the collision equation to determine the
+// logarithm, composite orders go through PohligHellman
 template <class GroupElem, class Int>
 class DiscreteLogarithmFinder {
 public:
-    DiscreteLogarithmFinder(GroupElem alpha, GroupElem beta, int64_t order)
-        : alpha_{alpha}, beta_{beta}, group_order_{order}, init_order_{order} {
+    DiscreteLogarithmFinder(GroupElem alpha, GroupElem beta, int64_t order,
+                            WalkOptions walk = WalkOptions::ThreePartition(),
+                            CycleDetection detection = CycleDetection::kFloyd)
+        : alpha_{alpha},
+          beta_{beta},
+          group_order_{order},
+          init_order_{order},
+          alpha_powers_{alpha, Int{order}},
+          beta_powers_{beta, Int{order}},
+          walk_options_{walk},
+          gen_{seed_++},
+          walk_{alpha, beta, order, walk, gen_},
+          detection_{detection} {
     }
 
     Int Find() const {
-        Triple slow = {GroupElem(), 0, 0};
-        while (true) {
-            Triple fast = slow;
-            while (true) {
-                slow = Next(slow);
-                fast = Next(Next(fast));
-                if (slow.x == fast.x) {
-                    Int A = slow.a - fast.a;
-                    Int B = fast.b - slow.b;
-                    if (B == 0) {
-                        slow = GetRandomTriple();
-                        break;
+        return *Run();
+    }
+
+    // Find() in another thread, stopped when token is stopped or at deadline, both checked
+    // every check_interval steps; the finder must outlive the future and run one search at a
+    // time. Group operations are counted in the stats only with an observer
+    std::future<FindResult<Int>> FindAsync(
+        StopToken token,
+        std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt,
+        uint64_t check_interval = 1024) const {
+        return std::async(std::launch::async, [this, token, deadline, check_interval] {
+            stop_token_ = token;
+            deadline_ = deadline;
+            check_interval_ = std::max<uint64_t>(check_interval, 1);
+            std::optional<Int> res = Run();
+            FindResult<Int> result{res ? FindStatus::kSolved : status_, res ? *res : Int{-1},
+                                   Stats()};
+            stop_token_ = StopToken();
+            deadline_ = std::nullopt;
+            check_interval_ = 0;
+            return result;
+        });
+    }
+
+    // evaluations of the iteration function made by the last Find(), ParallelFind(),
+    // PersistentFind() or RunWalks(), summed over all threads
+    uint64_t Evaluations() const {
+        return evaluations_;
+    }
+
+    // observer is called every interval steps of Find() and once with the final stats; without
+    // one Find() does not count group operations and never reads the clock
+    void SetObserver(FinderObserver observer, uint64_t interval = uint64_t{1} << 16) {
+        observer_ = std::move(observer);
+        observer_interval_ = interval;
+    }
+
+    // runs num_threads independent walks that report distinguished points to a shared table
+    // and solves on the first collision between two walks; throws std::invalid_argument for
+    // zero threads
+    Int ParallelFind(size_t num_threads, int dp_bits = -1) const {
+        if (num_threads == 0) {
+            throw std::invalid_argument("ParallelFind needs at least one thread");
+        }
+        if (dp_bits < 0) {
+            dp_bits = DefaultDistinguishedBits(init_order_);
+        }
+        DistinguishedPointTable<GroupElem, Int> table;
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> evaluations{0};
+        std::once_flag solved;
+        Int result;
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, &table, &done, &evaluations, &solved, &result, dp_bits,
+                                  seed = gen_()] {
+                std::mt19937 gen(seed);
+                auto res = WalkToCollision(walk_, table, done, dp_bits, gen, GetRandomTriple(gen),
+                                           [](const Triple&) {}, evaluations);
+                if (res) {
+                    std::call_once(solved, [&] { result = *res; });
+                    done = true;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        evaluations_ = evaluations;
+        return result;
+    }
+
+    // ParallelFind that keeps the distinguished points and the last distinguished point of
+    // every walk in the file at path; a run that was stopped or crashed resumes from it with the
+    // same iteration function instead of starting over. The file is synced to disk every
+    // sync_interval distinguished points, throws std::runtime_error if it belongs to another
+    // problem or dp_bits and std::invalid_argument for zero threads
+    Int PersistentFind(const std::string& path, size_t num_threads = 1, int dp_bits = -1,
+                       uint64_t sync_interval = 1024) const {
+        if (num_threads == 0) {
+            throw std::invalid_argument("PersistentFind needs at least one thread");
+        }
+        if (dp_bits < 0) {
+            dp_bits = DefaultDistinguishedBits(init_order_);
+        }
+        auto hash = std::hash<GroupElem>{};
+        DistinguishedPointStore store(
+            path, {init_order_, hash(alpha_), hash(beta_), dp_bits, walk_options_,
+                   static_cast<uint32_t>(gen_()), static_cast<uint32_t>(num_threads)});
+        // the walk of the run that created the file, its points would not meet ours otherwise
+        std::mt19937 walk_gen(store.Params().walk_seed);
+        RhoWalk<GroupElem, Int> walk(alpha_, beta_, init_order_, walk_options_, walk_gen);
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> stored{0};
+        std::atomic<uint64_t> evaluations{0};
+        std::once_flag solved;
+        Int result;
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, &store, &walk, &done, &stored, &evaluations, &solved,
+                                  &result, dp_bits, sync_interval, i, seed = gen_()] {
+                std::mt19937 gen(seed);
+                Triple start = GetRandomTriple(gen);
+                if (auto saved = store.LoadWalk(i)) {
+                    start.a = Int{saved->first};
+                    start.b = Int{saved->second};
+                    start.x = alpha_powers_.Power(start.a) + beta_powers_.Power(start.b);
+                }
+                auto checkpoint = [&store, &stored, sync_interval, i](const Triple& t) {
+                    if (i < store.Params().walks) {
+                        store.SaveWalk(i, NarrowToInt64(t.a), NarrowToInt64(t.b));
                     }
-                    // find solution of A = Bx (mod n)
-                    Int res = SolveEquation<Int>(A, B, group_order_);
-                    return res;
+                    if (++stored % sync_interval == 0) {
+                        store.Sync();
+                    }
+                };
+                auto res = WalkToCollision(walk, store, done, dp_bits, gen, start, checkpoint,
+                                           evaluations);
+                if (res) {
+                    std::call_once(solved, [&] { result = *res; });
+                    done = true;
                 }
-            }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
         }
+        evaluations_ = evaluations;
+        return result;
+    }
+
+    // num_threads walks of the iteration function seeded by walk_seed from starts drawn with
+    // start_seed that report their distinguished points to table until done, for tables that
+    // detect collisions on their own (in another process)
+    template <class Table>
+    void RunWalks(Table& table, uint32_t walk_seed, uint32_t start_seed, size_t num_threads,
+                  int dp_bits, const std::atomic<bool>& done) const {
+        std::mt19937 walk_gen(walk_seed);
+        RhoWalk<GroupElem, Int> walk(alpha_, beta_, init_order_, walk_options_, walk_gen);
+        std::mt19937 start_gen(start_seed);
+        std::atomic<uint64_t> evaluations{0};
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, &table, &walk, &done, &evaluations, dp_bits,
+                                  seed = start_gen()] {
+                std::mt19937 gen(seed);
+                WalkToCollision(walk, table, done, dp_bits, gen, GetRandomTriple(gen),
+                                [](const Triple&) {}, evaluations);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        evaluations_ = evaluations;
     }
 
 private:
-    static std::mt19937 gen_;
+    // every finder draws from its own generator so that finders can run in different threads
+    static std::atomic<uint32_t> seed_;
+
+    using Triple = WalkTriple<GroupElem, Int>;
+
+    // the single-walk search, empty if FindAsync() stopped it
+    std::optional<Int> Run() const {
+        evaluations_ = 0;
+        restarts_ = 0;
+        counters_ = {};
+        next_report_ = observer_interval_;
+        stopped_ = false;
+        next_check_ = check_interval_ ? check_interval_ : std::numeric_limits<uint64_t>::max();
+        if (observer_ || check_interval_) {
+            start_time_ = std::chrono::steady_clock::now();
+        }
+        escapes_.clear();
+        Triple start = {GroupElem(), 0, 0};
+        while (true) {
+            auto [first, second] = DetectCycle(start);
+            if (stopped_) {
+                return std::nullopt;
+            }
+            if (auto res = SolveCollision(first.a, first.b, second.a, second.b, group_order_)) {
+                if (observer_) {
+                    observer_(Stats());
+                }
+                return *res;
+            }
+            ++restarts_;
+            if (walk_.NegationMap()) {
+                // a fruitless cycle that random starts would keep falling into, the walk is
+                // redefined to double at its smallest point which breaks the cycle for good.
+                // a cycle with no point left to escape at is one of doublings only in a small
+                // group, the walk is reset then and starts over from a random point
+                if (auto min = CycleMinimum(first)) {
+                    escapes_.insert(*min);
+                    start = first;
+                } else {
+                    escapes_.clear();
+                    start = GetRandomTriple();
+                }
+            } else {
+                start = GetRandomTriple();
+            }
+        }
+    }
 
-    // invariant: x = alpha^a * beta^b
-    struct Triple {
-        GroupElem x;
-        Int a;
-        Int b;
-    };
+    // sets stopped_ when FindAsync() asks to stop, the cycle detectors then return early
+    void CheckStop() const {
+        next_check_ += check_interval_;
+        if (stop_token_.StopRequested()) {
+            stopped_ = true;
+            status_ = FindStatus::kCancelled;
+        } else if (deadline_ && std::chrono::steady_clock::now() >= *deadline_) {
+            stopped_ = true;
+            status_ = FindStatus::kTimedOut;
+        }
+    }
 
     Triple GetRandomTriple() const {
+        return GetRandomTriple(gen_);
+    }
+
+    Triple GetRandomTriple(std::mt19937& gen) const {
         std::uniform_int_distribution<int64_t> dist(0, init_order_ - 1);
         Triple res;
-        res.a = Int{dist(gen_)};
-        res.b = Int{dist(gen_)};
-        res.x = alpha_.Power(res.a) + beta_.Power(res.b);
+        res.a = Int{dist(gen)};
+        res.b = Int{dist(gen)};
+        res.x = alpha_powers_.Power(res.a) + beta_powers_.Power(res.b);
         return res;
     }
 
-    Triple Next(Triple t) const {
-        auto hash = std::hash<GroupElem>{};
-        if (hash(t.x) % 3 == 0) {
-            return Triple{t.x + beta_, t.a, (t.b + Int{1}) % group_order_};
-        } else if (hash(t.x) % 3 == 1) {
-            return Triple{t.x + t.x, (t.a * Int{2}) % group_order_, (t.b * Int{2}) % group_order_};
+    // one worker of ParallelFind walking from t, empty when another worker finished first;
+    // checkpoint sees every distinguished point after it went into the table. the steps taken
+    // are added to evaluations once on return
+    template <class Table, class Checkpoint>
+    std::optional<Int> WalkToCollision(const RhoWalk<GroupElem, Int>& walk, Table& table,
+                                       const std::atomic<bool>& done, int dp_bits,
+                                       std::mt19937& gen, Triple t, Checkpoint checkpoint,
+                                       std::atomic<uint64_t>& evaluations) const {
+        const int64_t max_length = MaxWalkLength(dp_bits);
+        WalkPartition part = walk.Classify(t.x, dp_bits);
+        TwoCycleGuard<GroupElem, Int> guard;
+        int64_t length = 0;
+        uint64_t steps = 0;
+        std::optional<Int> res;
+        while (!done.load(std::memory_order_relaxed)) {
+            walk.Step(t, part, dp_bits);
+            ++steps;
+            if (walk.NegationMap() && guard.Check(walk, t.x, t.a, t.b)) {
+                part = walk.Classify(t.x, dp_bits);
+                ++steps;
+            }
+            ++length;
+            if (!part.distinguished) {
+                if (length > max_length) {
+                    t = GetRandomTriple(gen);
+                    part = walk.Classify(t.x, dp_bits);
+                    length = 0;
+                }
+                continue;
+            }
+            length = 0;
+            auto prev = table.Insert(t);
+            if (!prev) {
+                checkpoint(t);
+                continue;
+            }
+            // a persistent table matches points by a 64-bit fingerprint, so check the answer
+            res = SolveCollision(t.a, t.b, prev->first, prev->second, group_order_);
+            if (res && alpha_.Power(*res) == beta_) {
+                break;
+            }
+            res.reset();
+            t = GetRandomTriple(gen);
+            part = walk.Classify(t.x, dp_bits);
+        }
+        evaluations.fetch_add(steps, std::memory_order_relaxed);
+        return res;
+    }
+
+    Triple Next(const Triple& t) const {
+        ++evaluations_;
+        if (evaluations_ >= next_check_) {
+            CheckStop();
+        }
+        if (observer_) {
+            return ObservedNext(t);
+        }
+        if (!escapes_.empty() && escapes_.count(t.x)) {
+            Triple res = t;
+            walk_.Double(res.x, res.a, res.b);
+            return res;
+        }
+        return walk_.Next(t);
+    }
+
+    // Next() that counts group operations and reports every observer_interval_ steps
+    Triple ObservedNext(const Triple& t) const {
+        Triple res = t;
+        if (!escapes_.empty() && escapes_.count(t.x)) {
+            walk_.Double(res.x, res.a, res.b);
+            ++counters_.doublings;
         } else {
-            return Triple{t.x + alpha_, (t.a + Int{1}) % group_order_, t.b};
+            res = walk_.Next(t, &counters_);
+        }
+        if (evaluations_ >= next_report_) {
+            next_report_ += observer_interval_;
+            observer_(Stats());
+        }
+        return res;
+    }
+
+    FinderStats Stats() const {
+        FinderStats stats;
+        stats.steps = evaluations_;
+        stats.additions = counters_.additions;
+        stats.doublings = counters_.doublings;
+        stats.inversions =
+            (counters_.additions + counters_.doublings) * InversionsPerAdd<GroupElem>::value;
+        stats.restarts = restarts_;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                      start_time_)
+                            .count();
+        double classes = walk_.NegationMap() ? 0.5 * init_order_ : init_order_;
+        stats.expected_steps = std::sqrt(M_PI * classes / 2);
+        return stats;
+    }
+
+    // the point of the cycle through t with the smallest hash that is neither the neutral element
+    // nor an escape already, empty if there is none; doubling either would not break the cycle
+    std::optional<GroupElem> CycleMinimum(const Triple& t) const {
+        auto hash = std::hash<GroupElem>{};
+        std::optional<GroupElem> min;
+        Triple cur = t;
+        do {
+            if (!(cur.x == GroupElem()) && !escapes_.count(cur.x) &&
+                (!min || hash(cur.x) < hash(*min))) {
+                min = cur.x;
+            }
+            cur = Next(cur);
+        } while (!(cur.x == t.x) && !stopped_);
+        return min;
+    }
+
+    // two triples of the walk from start with equal x
+    std::pair<Triple, Triple> DetectCycle(const Triple& start) const {
+        switch (detection_) {
+            case CycleDetection::kBrent:
+                return BrentCycle(start);
+            case CycleDetection::kNivasch:
+                return NivaschCycle(start);
+            default:
+                return FloydCycle(start);
+        }
+    }
+
+    std::pair<Triple, Triple> FloydCycle(const Triple& start) const {
+        Triple slow = start;
+        Triple fast = start;
+        do {
+            slow = Next(slow);
+            fast = Next(Next(fast));
+        } while (!(slow.x == fast.x) && !stopped_);
+        return {slow, fast};
+    }
+
+    std::pair<Triple, Triple> BrentCycle(const Triple& start) const {
+        Triple tortoise = start;
+        Triple hare = Next(start);
+        uint64_t power = 1;
+        uint64_t length = 1;
+        while (!(tortoise.x == hare.x) && !stopped_) {
+            if (power == length) {
+                tortoise = hare;
+                power *= 2;
+                length = 0;
+            }
+            hare = Next(hare);
+            ++length;
+        }
+        return {tortoise, hare};
+    }
+
+    std::pair<Triple, Triple> NivaschCycle(const Triple& start) const {
+        auto hash = std::hash<GroupElem>{};
+        std::vector<std::pair<size_t, Triple>> stack;
+        Triple t = start;
+        while (!stopped_) {
+            size_t key = hash(t.x);
+            while (!stack.empty() && stack.back().first > key) {
+                stack.pop_back();
+            }
+            if (!stack.empty() && stack.back().first == key && stack.back().second.x == t.x) {
+                return {stack.back().second, t};
+            }
+            stack.emplace_back(key, t);
+            t = Next(t);
         }
+        return {t, t};
     }
 
     GroupElem alpha_;
     GroupElem beta_;
     Int group_order_;
     int64_t init_order_;
+    // tables for the random starts, every restart raises both bases
+    typename FixedBaseOf<GroupElem, Int>::type alpha_powers_;
+    typename FixedBaseOf<GroupElem, Int>::type beta_powers_;
+    WalkOptions walk_options_;
+    mutable std::mt19937 gen_;
+    RhoWalk<GroupElem, Int> walk_;
+    CycleDetection detection_;
+    mutable uint64_t evaluations_ = 0;
+    mutable std::unordered_set<GroupElem> escapes_;  // points where the walk doubles instead
+    FinderObserver observer_;
+    uint64_t observer_interval_ = 0;
+    mutable uint64_t next_report_ = 0;
+    mutable uint64_t restarts_ = 0;
+    mutable WalkCounters counters_;
+    mutable std::chrono::steady_clock::time_point start_time_;
+    mutable StopToken stop_token_;
+    mutable std::optional<std::chrono::steady_clock::time_point> deadline_;
+    mutable uint64_t check_interval_ = 0;  // 0 outside FindAsync()
+    mutable uint64_t next_check_ = 0;
+    mutable bool stopped_ = false;
+    mutable FindStatus status_ = FindStatus::kSolved;
 };
 
 template <class GroupElem, class Int>
-std::mt19937 DiscreteLogarithmFinder<GroupElem, Int>::gen_(42);
\ No newline at end of file
+std::atomic<uint32_t> DiscreteLogarithmFinder<GroupElem, Int>::seed_(42);
\ No newline at end of file
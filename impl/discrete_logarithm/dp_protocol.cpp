@@ -0,0 +1,155 @@
+#include "dp_protocol.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+[[noreturn]] void Fail(const std::string& what, int fd) {
+    std::string message = "rho protocol: " + what + ": " + std::strerror(errno);
+    if (fd >= 0) {
+        close(fd);
+    }
+    throw std::runtime_error(message);
+}
+
+sockaddr_in Address(const std::string& address, uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        errno = EINVAL;
+        Fail("bad address " + address, -1);
+    }
+    return addr;
+}
+
+// batches are already large, waiting for more data only delays collisions
+void SetNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+bool SendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool ReceiveAll(int fd, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = recv(fd, data, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+}  // namespace
+
+int64_t SteadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int ListenSocket(const std::string& address, uint16_t& port) {
+    sockaddr_in addr = Address(address, port);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        Fail("socket", fd);
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        Fail("cannot bind " + address + ":" + std::to_string(port), fd);
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+        Fail("listen", fd);
+    }
+    socklen_t length = sizeof(addr);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        Fail("getsockname", fd);
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+int ConnectSocket(const std::string& address, uint16_t port) {
+    sockaddr_in addr = Address(address, port);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        Fail("socket", fd);
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        Fail("cannot connect to " + address + ":" + std::to_string(port), fd);
+    }
+    SetNoDelay(fd);
+    return fd;
+}
+
+int AcceptSocket(int listen_fd) {
+    int fd;
+    do {
+        fd = accept(listen_fd, nullptr, nullptr);
+    } while (fd < 0 && errno == EINTR);
+    if (fd >= 0) {
+        SetNoDelay(fd);
+    }
+    return fd;
+}
+
+void ShutdownSocket(int fd) {
+    shutdown(fd, SHUT_RDWR);
+}
+
+void CloseSocket(int fd) {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool SendFrame(int fd, DistributedMessage type, const void* payload, size_t length) {
+    FrameHeader header{static_cast<uint32_t>(type), static_cast<uint32_t>(length)};
+    const char* header_bytes = reinterpret_cast<const char*>(&header);
+    const char* payload_bytes = static_cast<const char*>(payload);
+    std::vector<char> frame(header_bytes, header_bytes + sizeof(header));
+    frame.insert(frame.end(), payload_bytes, payload_bytes + length);
+    return SendAll(fd, frame.data(), frame.size());
+}
+
+bool ReceiveFrame(int fd, DistributedMessage& type, std::vector<char>& payload) {
+    FrameHeader header;
+    if (!ReceiveAll(fd, reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    if (header.length > kMaxFramePayload) {
+        return false;
+    }
+    type = static_cast<DistributedMessage>(header.type);
+    payload.resize(header.length);
+    return ReceiveAll(fd, payload.data(), payload.size());
+}
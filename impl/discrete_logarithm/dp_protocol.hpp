@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// wire format between a rho coordinator and its workers: frames of a FrameHeader and
+// `length` payload bytes, fixed-width fields in the byte order of the hosts (all current
+// targets are little-endian)
+enum class DistributedMessage : uint32_t {
+    kJob = 1,    // coordinator -> worker, JobMessage
+    kBatch = 2,  // worker -> coordinator, BatchHeader and DistinguishedPointRecord[]
+    kStop = 3,   // coordinator -> worker, empty
+};
+
+struct FrameHeader {
+    uint32_t type;
+    uint32_t length;
+};
+
+// the problem and the iteration function every worker has to walk with
+struct JobMessage {
+    int64_t order;
+    uint64_t alpha_hash;
+    uint64_t beta_hash;
+    int32_t dp_bits;
+    int32_t adding_slots;
+    int32_t doubling_slots;
+    uint8_t pollard;
+    uint8_t negation_map;
+    uint8_t beta_independent;
+    uint8_t reserved;
+    uint32_t walk_seed;
+    uint32_t start_seed;  // differs between workers
+};
+
+struct BatchHeader {
+    // steady clock when the first point of the batch was found, steady clocks agree between
+    // processes of one host only
+    int64_t first_point_ns;
+};
+
+// 24 bytes per distinguished point
+struct DistinguishedPointRecord {
+    uint64_t fingerprint;
+    int64_t a;
+    int64_t b;
+};
+
+// points of one batch and the largest payload ReceiveFrame() accepts
+inline constexpr size_t kMaxBatchPoints = size_t{1} << 16;
+inline constexpr size_t kMaxFramePayload =
+    sizeof(BatchHeader) + kMaxBatchPoints * sizeof(DistinguishedPointRecord);
+
+static_assert(sizeof(FrameHeader) == 8);
+static_assert(sizeof(JobMessage) == 48);
+static_assert(sizeof(BatchHeader) == 8);
+static_assert(sizeof(DistinguishedPointRecord) == 24);
+
+// steady clock in nanoseconds
+int64_t SteadyNanoseconds();
+
+// TCP socket listening on address:port, port 0 picks a free port and is replaced by it;
+// throws std::runtime_error
+int ListenSocket(const std::string& address, uint16_t& port);
+
+// TCP socket connected to address:port, throws std::runtime_error
+int ConnectSocket(const std::string& address, uint16_t port);
+
+// next connection on a listening socket, -1 on failure
+int AcceptSocket(int listen_fd);
+
+// wakes up a thread blocked on fd, the descriptor still has to be closed
+void ShutdownSocket(int fd);
+
+void CloseSocket(int fd);
+
+// false if the peer is gone
+bool SendFrame(int fd, DistributedMessage type, const void* payload, size_t length);
+
+// blocks for a whole frame, false if the peer is gone or announces more than kMaxFramePayload
+// bytes
+bool ReceiveFrame(int fd, DistributedMessage& type, std::vector<char>& payload);
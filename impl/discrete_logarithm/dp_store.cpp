@@ -0,0 +1,216 @@
+#include "dp_store.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'H', 'O', 'D', 'P', 'S', 'T', '1'};
+constexpr uint64_t kInitialRecords = 1 << 12;
+
+}  // namespace
+
+struct DistinguishedPointStore::Header {
+    char magic[8];
+    int64_t order;
+    uint64_t alpha_hash;
+    uint64_t beta_hash;
+    int32_t dp_bits;
+    int32_t adding_slots;
+    int32_t doubling_slots;
+    uint8_t pollard;
+    uint8_t negation_map;
+    uint8_t beta_independent;
+    uint8_t reserved;
+    uint32_t walk_seed;
+    uint32_t walks;
+    uint64_t record_capacity;
+    uint64_t records;  // written last, a record counts once this covers it
+};
+
+struct DistinguishedPointStore::WalkSlot {
+    int64_t a;
+    int64_t b;
+    uint64_t saved;
+};
+
+struct DistinguishedPointStore::Record {
+    uint64_t fingerprint;
+    int64_t a;
+    int64_t b;
+};
+
+DistinguishedPointStore::DistinguishedPointStore(const std::string& path,
+                                                 const DistinguishedPointStoreParams& params)
+    : params_(params) {
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        Fail("cannot open " + path);
+    }
+    if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        Fail(path + " is used by another process");
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        Fail("cannot stat " + path);
+    }
+
+    resumed_ = st.st_size > 0;
+    if (!resumed_) {
+        Map(FileSize(kInitialRecords));
+        Header* header = GetHeader();
+        std::memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->order = params.order;
+        header->alpha_hash = params.alpha_hash;
+        header->beta_hash = params.beta_hash;
+        header->dp_bits = params.dp_bits;
+        header->adding_slots = params.walk.adding_slots;
+        header->doubling_slots = params.walk.doubling_slots;
+        header->pollard = params.walk.pollard;
+        header->negation_map = params.walk.negation_map;
+        header->beta_independent = params.walk.beta_independent;
+        header->walk_seed = params.walk_seed;
+        header->walks = params.walks;
+        header->record_capacity = kInitialRecords;
+        header->records = 0;
+        return;
+    }
+
+    if (static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        errno = EINVAL;
+        Fail(path + " is truncated");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    Map(size_);
+    const Header* header = GetHeader();
+    params_.walk_seed = header->walk_seed;
+    params_.walks = header->walks;
+    bool same = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                header->order == params.order && header->alpha_hash == params.alpha_hash &&
+                header->beta_hash == params.beta_hash && header->dp_bits == params.dp_bits &&
+                header->adding_slots == params.walk.adding_slots &&
+                header->doubling_slots == params.walk.doubling_slots &&
+                header->pollard == params.walk.pollard &&
+                header->negation_map == params.walk.negation_map &&
+                header->beta_independent == params.walk.beta_independent &&
+                FileSize(header->record_capacity) <= size_;
+    if (!same) {
+        errno = EINVAL;
+        Fail(path + " belongs to another discrete logarithm or walk");
+    }
+    const Record* records = Records();
+    index_.reserve(header->records);
+    for (uint64_t i = 0; i < header->records; ++i) {
+        index_.emplace(records[i].fingerprint, std::make_pair(records[i].a, records[i].b));
+    }
+}
+
+DistinguishedPointStore::~DistinguishedPointStore() {
+    if (data_) {
+        msync(data_, size_, MS_SYNC);
+    }
+    Release();
+}
+
+size_t DistinguishedPointStore::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+std::optional<std::pair<int64_t, int64_t>> DistinguishedPointStore::Insert(uint64_t fingerprint,
+                                                                           int64_t a, int64_t b) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = index_.emplace(fingerprint, std::make_pair(a, b));
+    if (!inserted) {
+        return it->second;
+    }
+    if (GetHeader()->records == GetHeader()->record_capacity) {
+        Grow();
+    }
+    Header* header = GetHeader();
+    Records()[header->records] = Record{fingerprint, a, b};
+    __atomic_store_n(&header->records, header->records + 1, __ATOMIC_RELEASE);
+    return std::nullopt;
+}
+
+void DistinguishedPointStore::SaveWalk(size_t i, int64_t a, int64_t b) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Walks()[i] = WalkSlot{a, b, 1};
+}
+
+std::optional<std::pair<int64_t, int64_t>> DistinguishedPointStore::LoadWalk(size_t i) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (i >= params_.walks || !Walks()[i].saved) {
+        return std::nullopt;
+    }
+    return std::make_pair(Walks()[i].a, Walks()[i].b);
+}
+
+void DistinguishedPointStore::Sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    msync(data_, size_, MS_SYNC);
+}
+
+DistinguishedPointStore::Header* DistinguishedPointStore::GetHeader() const {
+    return static_cast<Header*>(data_);
+}
+
+DistinguishedPointStore::WalkSlot* DistinguishedPointStore::Walks() const {
+    return reinterpret_cast<WalkSlot*>(static_cast<char*>(data_) + sizeof(Header));
+}
+
+DistinguishedPointStore::Record* DistinguishedPointStore::Records() const {
+    return reinterpret_cast<Record*>(Walks() + params_.walks);
+}
+
+size_t DistinguishedPointStore::FileSize(uint64_t record_capacity) const {
+    return sizeof(Header) + params_.walks * sizeof(WalkSlot) + record_capacity * sizeof(Record);
+}
+
+void DistinguishedPointStore::Map(size_t size) {
+    if (data_) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        Fail("cannot resize the file");
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        Fail("cannot map the file");
+    }
+    data_ = data;
+    size_ = size;
+}
+
+void DistinguishedPointStore::Release() {
+    if (data_) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+// the constructor throws before the destructor could release the file and its lock
+void DistinguishedPointStore::Fail(const std::string& what) {
+    std::string message = "DistinguishedPointStore: " + what + ": " + std::strerror(errno);
+    Release();
+    throw std::runtime_error(message);
+}
+
+// doubles the record capacity, records already written stay where they are
+void DistinguishedPointStore::Grow() {
+    uint64_t capacity = GetHeader()->record_capacity * 2;
+    Map(FileSize(capacity));
+    GetHeader()->record_capacity = capacity;
+}
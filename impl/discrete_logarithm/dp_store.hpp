@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <discrete_logarithm/walk.hpp>
+
+inline int64_t NarrowToInt64(int64_t v) {
+    return v;
+}
+
+template <class Int>
+int64_t NarrowToInt64(const Int& v) {
+    return v.NarrowToInt();
+}
+
+// what a store was created for, a store is only resumed by a run with the same parameters
+struct DistinguishedPointStoreParams {
+    int64_t order;
+    uint64_t alpha_hash;
+    uint64_t beta_hash;
+    int dp_bits;
+    WalkOptions walk;
+    uint32_t walk_seed;  // seeds the iteration function, taken from the file on resume
+    uint32_t walks;      // walk-state slots, fixed when the file is created
+};
+
+// distinguished-point table in an append-only memory-mapped file: a header with the
+// parameters, one (a, b) slot per walk for its latest checkpoint and records of a point
+// fingerprint with its (a, b); reopening reads the records into memory, so restart time is
+// linear in the table size. Writes go to a shared mapping and survive a crash of the process,
+// Sync() also makes them survive a crash of the machine. Thread-safe, one process per file.
+class DistinguishedPointStore {
+public:
+    // opens path or creates it for params, throws std::runtime_error if the file belongs to
+    // a run with other parameters or cannot be mapped
+    DistinguishedPointStore(const std::string& path, const DistinguishedPointStoreParams& params);
+    ~DistinguishedPointStore();
+
+    DistinguishedPointStore(const DistinguishedPointStore&) = delete;
+    DistinguishedPointStore& operator=(const DistinguishedPointStore&) = delete;
+
+    // parameters found in the file, equal to the requested ones except walk_seed and walks
+    const DistinguishedPointStoreParams& Params() const {
+        return params_;
+    }
+
+    // true if the file existed, Size() records were loaded from it
+    bool Resumed() const {
+        return resumed_;
+    }
+
+    size_t Size() const;
+
+    // appends (fingerprint, a, b), returns the coefficients the fingerprint was stored with
+    // before instead if it was
+    std::optional<std::pair<int64_t, int64_t>> Insert(uint64_t fingerprint, int64_t a, int64_t b);
+
+    template <class GroupElem, class Int>
+    std::optional<std::pair<Int, Int>> Insert(const WalkTriple<GroupElem, Int>& t) {
+        auto prev = Insert(std::hash<GroupElem>{}(t.x), NarrowToInt64(t.a), NarrowToInt64(t.b));
+        if (!prev) {
+            return std::nullopt;
+        }
+        return std::make_pair(Int{prev->first}, Int{prev->second});
+    }
+
+    // checkpoint of walk i < Params().walks
+    void SaveWalk(size_t i, int64_t a, int64_t b);
+    std::optional<std::pair<int64_t, int64_t>> LoadWalk(size_t i) const;
+
+    // flushes the mapping to disk
+    void Sync();
+
+private:
+    struct Header;
+    struct WalkSlot;
+    struct Record;
+
+    Header* GetHeader() const;
+    WalkSlot* Walks() const;
+    Record* Records() const;
+    size_t FileSize(uint64_t record_capacity) const;
+    void Map(size_t size);
+    void Grow();
+    void Release();
+    [[noreturn]] void Fail(const std::string& what);
+
+    mutable std::mutex mutex_;
+    DistinguishedPointStoreParams params_;
+    bool resumed_ = false;
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    std::unordered_map<uint64_t, std::pair<int64_t, int64_t>> index_;
+};
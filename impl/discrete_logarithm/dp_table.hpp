@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include <discrete_logarithm/walk.hpp>
+#include <extended_euclidean/extended_euclidean.hpp>
+
+// keeps the table at about sqrt(order) / 2^(log2(order) / 8) entries
+inline int DefaultDistinguishedBits(int64_t order) {
+    int bits = 0;
+    while (order > 1) {
+        order >>= 1;
+        ++bits;
+    }
+    return bits / 8;
+}
+
+// x = alpha^a * beta^b = alpha^a' * beta^b' gives a - a' = x(b' - b) (mod n),
+// empty when b' - b = 0 and the collision says nothing about x
+template <class Int>
+std::optional<Int> SolveCollision(const Int& a, const Int& b, const Int& other_a,
+                                  const Int& other_b, const Int& order) {
+    Int A = a - other_a;
+    Int B = other_b - b;
+    if (B == 0) {
+        return std::nullopt;
+    }
+    return SolveEquation<Int>(A, B, order);
+}
+
+// thread-safe map from distinguished points to the coefficients they were reached with
+template <class GroupElem, class Int>
+class DistinguishedPointTable {
+public:
+    using Triple = WalkTriple<GroupElem, Int>;
+
+    // stores t, returns the coefficients t.x was reported with before if it was
+    std::optional<std::pair<Int, Int>> Insert(const Triple& t) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = table_.emplace(t.x, std::make_pair(t.a, t.b));
+        if (inserted) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return table_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<GroupElem, std::pair<Int, Int>> table_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+inline uint64_t MulMod64(uint64_t a, uint64_t b, uint64_t mod) {
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % mod);
+}
+
+inline uint64_t PowMod64(uint64_t base, uint64_t exp, uint64_t mod) {
+    uint64_t result = 1 % mod;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) {
+            result = MulMod64(result, base, mod);
+        }
+        base = MulMod64(base, base, mod);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// Miller-Rabin, the first 12 prime bases are deterministic below 2^64
+inline bool IsPrime64(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    for (uint64_t p : bases) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    uint64_t d = n - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        ++s;
+    }
+    for (uint64_t a : bases) {
+        uint64_t x = PowMod64(a, d, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < s && composite; ++i) {
+            x = MulMod64(x, x, n);
+            composite = (x != n - 1);
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a nontrivial divisor of an odd composite n by Pollard's rho with Brent's cycle detection
+inline uint64_t PollardBrentDivisor(uint64_t n) {
+    for (uint64_t c = 1;; ++c) {
+        auto f = [&](uint64_t x) { return (MulMod64(x, x, n) + c) % n; };
+        uint64_t x = 2, y = 2, d = 1;
+        for (uint64_t power = 1; d == 1; power *= 2) {
+            x = y;
+            for (uint64_t i = 0; i < power && d == 1; ++i) {
+                y = f(y);
+                d = std::gcd(x > y ? x - y : y - x, n);
+            }
+        }
+        if (d != n) {
+            return d;
+        }
+    }
+}
+
+// prime factorization of n > 0 as sorted (prime, exponent) pairs
+inline std::vector<std::pair<int64_t, int>> Factorize(int64_t n) {
+    std::vector<uint64_t> primes;
+    uint64_t m = static_cast<uint64_t>(n);
+    for (uint64_t p = 2; p < (1 << 12) && p * p <= m; ++p) {
+        while (m % p == 0) {
+            primes.push_back(p);
+            m /= p;
+        }
+    }
+    std::vector<uint64_t> stack;
+    if (m > 1) {
+        stack.push_back(m);
+    }
+    while (!stack.empty()) {
+        uint64_t cur = stack.back();
+        stack.pop_back();
+        if (IsPrime64(cur)) {
+            primes.push_back(cur);
+            continue;
+        }
+        uint64_t d = PollardBrentDivisor(cur);
+        stack.push_back(d);
+        stack.push_back(cur / d);
+    }
+    std::sort(primes.begin(), primes.end());
+
+    std::vector<std::pair<int64_t, int>> factors;
+    for (uint64_t p : primes) {
+        if (!factors.empty() && factors.back().first == static_cast<int64_t>(p)) {
+            ++factors.back().second;
+        } else {
+            factors.emplace_back(static_cast<int64_t>(p), 1);
+        }
+    }
+    return factors;
+}
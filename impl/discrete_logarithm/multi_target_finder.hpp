@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <discrete_logarithm/dp_table.hpp>
+#include <discrete_logarithm/walk.hpp>
+#include <extended_euclidean/extended_euclidean.hpp>
+
+// GroupElem requires what BatchedDiscreteLogarithmFinder requires
+
+// logarithms of many targets beta_1, beta_2, ... to one base alpha (Kuhn-Struik): the walk is
+// WalkOptions::BetaIndependent(), so it is the same for every target and a distinguished point
+// keeps its value once the target it was found for is solved, its logarithm is then known.
+// The batch_size lockstep walks of a target stop at the first distinguished point that is known
+// or was reached by another walk of the same target with other coefficients. The table keeps
+// the distinguished points of every call, so the later targets get cheaper and m targets cost
+// about sqrt(2 m q) group operations in total instead of m sqrt(pi q / 2)
+template <class GroupElem, class Int>
+class MultiTargetDiscreteLogarithmFinder {
+public:
+    MultiTargetDiscreteLogarithmFinder(GroupElem alpha, int64_t order, size_t batch_size = 64,
+                                       int dp_bits = -1, WalkOptions walk = WalkOptions::Adding(20))
+        : alpha_{alpha},
+          group_order_{order},
+          init_order_{order},
+          alpha_powers_{alpha, Int{order}},
+          batch_size_{batch_size},
+          dp_bits_{dp_bits < 0 ? DefaultDistinguishedBits(order) : dp_bits},
+          walk_{alpha, alpha, order, walk.BetaIndependent(), gen_} {
+    }
+
+    // log_alpha beta for beta in the group generated by alpha, every earlier target and its
+    // distinguished points stay in the table
+    Int Find(const GroupElem& beta) {
+        size_t target = logs_.size();
+        uint64_t start_additions = additions_;
+
+        std::vector<GroupElem> x(batch_size_);
+        std::vector<Int> a(batch_size_);
+        std::vector<Int> b(batch_size_);
+        std::vector<int64_t> length(batch_size_, 0);
+        std::vector<WalkPartition> part(batch_size_);
+        std::vector<TwoCycleGuard<GroupElem, Int>> guards(batch_size_);
+        BatchStepBuffers<GroupElem, Int> buffers;
+        for (size_t i = 0; i < batch_size_; ++i) {
+            Restart(beta, x[i], a[i], b[i], part[i]);
+        }
+
+        const int64_t max_length = MaxWalkLength(dp_bits_);
+        while (true) {
+            additions_ += walk_.BatchStep(x, a, b, part, dp_bits_, buffers);
+
+            for (size_t i = 0; i < batch_size_; ++i) {
+                // 2-cycles left once BatchStep() tried every slot
+                if (walk_.NegationMap() && guards[i].Check(walk_, x[i], a[i], b[i])) {
+                    part[i] = walk_.Classify(x[i], dp_bits_);
+                    ++additions_;
+                }
+                ++length[i];
+                if (!part[i].distinguished) {
+                    if (length[i] > max_length) {
+                        Restart(beta, x[i], a[i], b[i], part[i]);
+                        length[i] = 0;
+                    }
+                    continue;
+                }
+                length[i] = 0;
+                auto [it, inserted] = table_.emplace(x[i], Entry{target, a[i], b[i]});
+                if (inserted) {
+                    continue;
+                }
+                auto res = Solve(it->second, target, a[i], b[i]);
+                if (res) {
+                    logs_.push_back(*res);
+                    last_additions_ = additions_ - start_additions;
+                    return *res;
+                }
+                // the walk would only repeat the one that reported this point
+                Restart(beta, x[i], a[i], b[i], part[i]);
+            }
+        }
+    }
+
+    // Find() of every target in order
+    std::vector<Int> FindAll(const std::vector<GroupElem>& betas) {
+        std::vector<Int> res;
+        res.reserve(betas.size());
+        for (const auto& beta : betas) {
+            res.push_back(Find(beta));
+        }
+        return res;
+    }
+
+    size_t Solved() const {
+        return logs_.size();
+    }
+
+    size_t TableSize() const {
+        return table_.size();
+    }
+
+    // group additions of the last Find() and of all calls together, including doublings
+    uint64_t LastAdditions() const {
+        return last_additions_;
+    }
+    uint64_t Additions() const {
+        return additions_;
+    }
+
+private:
+    // a distinguished point x = alpha^a * beta^b with beta the target-th target
+    struct Entry {
+        size_t target;
+        Int a;
+        Int b;
+    };
+
+    // log of the current target from x = alpha^a * beta^b reaching the point of prev
+    std::optional<Int> Solve(const Entry& prev, size_t target, const Int& a, const Int& b) const {
+        if (prev.target == target) {
+            return SolveCollision(a, b, prev.a, prev.b, group_order_);
+        }
+        // prev is known: x = alpha^known, so b log = known - a
+        if (b == 0) {
+            return std::nullopt;
+        }
+        Int known = (prev.a + prev.b * logs_[prev.target]) % group_order_;
+        return SolveEquation<Int>(known - a, b, group_order_);
+    }
+
+    void Restart(const GroupElem& beta, GroupElem& x, Int& a, Int& b, WalkPartition& part) {
+        std::uniform_int_distribution<int64_t> dist(0, init_order_ - 1);
+        a = Int{dist(gen_)};
+        b = Int{dist(gen_)};
+        x = alpha_powers_.Power(a) + beta.Power(b);
+        part = walk_.Classify(x, dp_bits_);
+    }
+
+    GroupElem alpha_;
+    Int group_order_;
+    int64_t init_order_;
+    typename FixedBaseOf<GroupElem, Int>::type alpha_powers_;
+    size_t batch_size_;
+    int dp_bits_;
+    std::mt19937 gen_{42};
+    RhoWalk<GroupElem, Int> walk_;
+    std::vector<Int> logs_;  // logs_[k] of the k-th target
+    std::unordered_map<GroupElem, Entry> table_;
+    uint64_t additions_ = 0;
+    uint64_t last_additions_ = 0;
+};
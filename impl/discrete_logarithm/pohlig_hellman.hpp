@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <discrete_logarithm/dl_finder.hpp>
+#include <discrete_logarithm/factorization.hpp>
+#include <discrete_logarithm/walk.hpp>
+#include <extended_euclidean/extended_euclidean.hpp>
+
+// GroupElem requires operator+(), operator==(), std::hash, Power()
+
+// solves alpha^x = beta for an alpha of composite order n = p1^e1 * ... * pk^ek:
+// x mod pi^ei is found digit by digit in base pi from logarithms in the subgroup of order pi,
+// the k prime powers are solved in parallel and recombined by the CRT
+template <class GroupElem, class Int>
+class PohligHellman {
+public:
+    PohligHellman(GroupElem alpha, GroupElem beta, int64_t order,
+                  WalkOptions walk = WalkOptions::ThreePartition())
+        : alpha_{alpha}, beta_{beta}, order_{order}, walk_{walk}, factors_{Factorize(order)} {
+    }
+
+    // logarithm in [0, order), -1 if beta is not a power of alpha
+    Int Find() const {
+        // beta outside <alpha> would leave the rho of some digit without a useful collision
+        if (!(beta_.Power(Int{order_}) == alpha_.Power(Int{0}))) {
+            return Int{-1};
+        }
+        std::vector<Int> residues(factors_.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < factors_.size(); ++i) {
+            workers.emplace_back([this, &residues, i] {
+                residues[i] = SolvePrimePower(factors_[i].first, factors_[i].second);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& r : residues) {
+            if (r < 0) {
+                return Int{-1};
+            }
+        }
+
+        // x = r (mod m) and x = r_i (mod m_i) give x = r + m * t with m * t = r_i - r (mod m_i)
+        Int x{0};
+        int64_t m = 1;
+        for (size_t i = 0; i < factors_.size(); ++i) {
+            int64_t m_i = PrimePower(factors_[i].first, factors_[i].second);
+            Int diff = ((residues[i] - x) % Int{m_i} + Int{m_i}) % Int{m_i};
+            x += Int{m} * SolveEquation<Int>(diff, Int{m % m_i}, Int{m_i});
+            m *= m_i;
+        }
+        // in a non-cyclic group beta^n = 1 does not put beta in <alpha>
+        return alpha_.Power(x) == beta_ ? x : Int{-1};
+    }
+
+    // prime factorization of the order as (prime, exponent) pairs
+    const std::vector<std::pair<int64_t, int>>& Factors() const {
+        return factors_;
+    }
+
+private:
+    // below this the subgroup logarithm is found by enumeration, rho needs a few restarts
+    // on tiny groups and would cost more
+    static constexpr int64_t kEnumerationLimit = 64;
+
+    static int64_t PrimePower(int64_t p, int e) {
+        int64_t res = 1;
+        for (int i = 0; i < e; ++i) {
+            res *= p;
+        }
+        return res;
+    }
+
+    // x mod p^e as x_0 + x_1 p + ... + x_{e-1} p^(e-1), where x_k is the logarithm of
+    // (beta * alpha^-(x mod p^k))^(n / p^(k+1)) to the base gamma = alpha^(n / p);
+    // -1 if a digit has no logarithm
+    Int SolvePrimePower(int64_t p, int e) const {
+        GroupElem gamma = alpha_.Power(Int{order_ / p});
+        Int x{0};
+        int64_t p_k = 1;
+        for (int k = 0; k < e; ++k) {
+            GroupElem h = (beta_ + alpha_.Power(Int{order_} - x)).Power(Int{order_ / p_k / p});
+            Int digit = SolvePrime(gamma, h, p);
+            if (digit < 0) {
+                return Int{-1};
+            }
+            x += Int{p_k} * digit;
+            p_k *= p;
+        }
+        return x;
+    }
+
+    // logarithm of h to the base gamma of prime order p, -1 if h is not a power of gamma
+    Int SolvePrime(const GroupElem& gamma, const GroupElem& h, int64_t p) const {
+        GroupElem neutral = gamma.Power(Int{0});
+        if (p < kEnumerationLimit) {
+            GroupElem cur = neutral;
+            for (int64_t i = 0; i < p; ++i) {
+                if (cur == h) {
+                    return Int{i};
+                }
+                cur = cur + gamma;
+            }
+            return Int{-1};
+        }
+        if (h == neutral) {
+            return Int{0};
+        }
+        // rho never terminates for an h outside <gamma>; h^p = 1 rules that out unless the
+        // p-torsion of the group is not cyclic
+        if (!(h.Power(Int{p}) == neutral)) {
+            return Int{-1};
+        }
+        DiscreteLogarithmFinder<GroupElem, Int> finder(gamma, h, p, walk_);
+        return finder.Find();
+    }
+
+    GroupElem alpha_;
+    GroupElem beta_;
+    int64_t order_;
+    WalkOptions walk_;
+    std::vector<std::pair<int64_t, int>> factors_;
+};
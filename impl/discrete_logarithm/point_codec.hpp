@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <discrete_logarithm/tonelli_shanks.hpp>
+#include <elliptic_curve/ec_point.hpp>
+#include <elliptic_curve/field.hpp>
+
+enum class PointFormat { kUncompressed, kCompressed };
+
+// fixed-size little-endian byte encodings of the points of one CurveContext, with L the byte
+// length of p: kUncompressed is x and y in L bytes each, kCompressed is x with the parity of y
+// in the bit just above the bit length of p. The neutral point is all 0xff bytes, never an x
+// below p. Compressed points are restored through a SqrtContext; the context must outlive the
+// codec
+template <class Int>
+class PointCodec {
+public:
+    explicit PointCodec(const CurveContext<Int>& ctx);
+
+    // bytes of one encoded point
+    size_t Size(PointFormat format) const;
+
+    void Encode(const ECPoint<Int>& P, PointFormat format, uint8_t* out) const;
+    // nullopt for coordinates not below p, points off the curve and x without a square root
+    std::optional<ECPoint<Int>> Decode(const uint8_t* in, PointFormat format) const;
+
+    // points into points.size() * Size(format) contiguous bytes
+    void EncodeAll(const std::vector<ECPoint<Int>>& points, PointFormat format, uint8_t* out) const;
+    std::vector<uint8_t> EncodeAll(const std::vector<ECPoint<Int>>& points,
+                                   PointFormat format) const;
+    // appends the n points of n * Size(format) contiguous bytes to points, false at the first
+    // invalid encoding
+    bool DecodeAll(const uint8_t* in, size_t n, PointFormat format,
+                   std::vector<ECPoint<Int>>& points) const;
+
+private:
+    void WriteInt(const Int& v, size_t bytes, uint8_t* out) const;
+    // limbs of bytes little-endian bytes
+    void ReadLimbs(const uint8_t* in, size_t bytes, std::vector<uint64_t>& limbs) const;
+    std::optional<ECPoint<Int>> Decode(const uint8_t* in, PointFormat format,
+                                       std::vector<uint64_t>& limbs) const;
+
+    const CurveContext<Int>* ctx_;
+    SqrtContext<Int> sqrt_;
+    FieldElem<Int> b_;
+    size_t bits_;              // bit length of p, the parity bit of the compressed form
+    size_t coord_bytes_;       // L
+    size_t compressed_bytes_;  // bytes of bits_ + 1 bits
+};
+
+template <class Int>
+PointCodec<Int>::PointCodec(const CurveContext<Int>& ctx)
+    : ctx_(&ctx),
+      sqrt_(ctx.Field()),
+      b_(ctx.Curve().B(), ctx.Field()),
+      bits_(BitLengthOf(ctx.Field().Prime())),
+      coord_bytes_((bits_ + 7) / 8),
+      compressed_bytes_((bits_ + 8) / 8) {
+}
+
+template <class Int>
+size_t PointCodec<Int>::Size(PointFormat format) const {
+    return format == PointFormat::kUncompressed ? 2 * coord_bytes_ : compressed_bytes_;
+}
+
+template <class Int>
+void PointCodec<Int>::WriteInt(const Int& v, size_t bytes, uint8_t* out) const {
+    for (size_t k = 0; k < bytes; ++k) {
+        out[k] = static_cast<uint8_t>(LimbOf(v, k / 8) >> (8 * (k % 8)));
+    }
+}
+
+template <class Int>
+void PointCodec<Int>::ReadLimbs(const uint8_t* in, size_t bytes,
+                                std::vector<uint64_t>& limbs) const {
+    limbs.assign((bytes + 7) / 8, 0);
+    for (size_t k = 0; k < bytes; ++k) {
+        limbs[k / 8] |= uint64_t{in[k]} << (8 * (k % 8));
+    }
+}
+
+template <class Int>
+void PointCodec<Int>::Encode(const ECPoint<Int>& P, PointFormat format, uint8_t* out) const {
+    size_t size = Size(format);
+    if (P.IsNeutral()) {
+        std::fill(out, out + size, uint8_t{0xff});
+        return;
+    }
+    if (format == PointFormat::kUncompressed) {
+        WriteInt(P.X(), coord_bytes_, out);
+        WriteInt(P.Y(), coord_bytes_, out + coord_bytes_);
+        return;
+    }
+    WriteInt(P.X(), compressed_bytes_, out);
+    out[bits_ / 8] |= static_cast<uint8_t>((LimbOf(P.Y(), 0) & 1) << (bits_ % 8));
+}
+
+template <class Int>
+std::optional<ECPoint<Int>> PointCodec<Int>::Decode(const uint8_t* in, PointFormat format) const {
+    std::vector<uint64_t> limbs;
+    return Decode(in, format, limbs);
+}
+
+template <class Int>
+std::optional<ECPoint<Int>> PointCodec<Int>::Decode(const uint8_t* in, PointFormat format,
+                                                    std::vector<uint64_t>& limbs) const {
+    size_t size = Size(format);
+    if (std::all_of(in, in + size, [](uint8_t byte) { return byte == 0xff; })) {
+        return ECPoint<Int>(*ctx_);
+    }
+    const PrimeField<Int>& field = ctx_->Field();
+    const Int& p = field.Prime();
+    ReadLimbs(in, coord_bytes_, limbs);
+    bool odd = false;
+    if (format == PointFormat::kCompressed) {
+        odd = (in[bits_ / 8] >> (bits_ % 8)) & 1;
+        // unless bits_ is a multiple of 8 the parity bit sits in the top byte of x
+        if (bits_ % 8 != 0) {
+            limbs[bits_ / 64] &= (uint64_t{1} << (bits_ % 64)) - 1;
+        }
+    }
+    Int x = IntFromLimbs<Int>(limbs.data(), limbs.size());
+    if (!(x < p)) {
+        return std::nullopt;
+    }
+    FieldElem<Int> X(x, field);
+    FieldElem<Int> rhs = X * X * X + ctx_->A() * X + b_;
+
+    if (format == PointFormat::kUncompressed) {
+        ReadLimbs(in + coord_bytes_, coord_bytes_, limbs);
+        Int y = IntFromLimbs<Int>(limbs.data(), limbs.size());
+        FieldElem<Int> Y(y, field);
+        if (!(y < p) || !(Y * Y == rhs)) {
+            return std::nullopt;
+        }
+        return ctx_->Point(x, y);
+    }
+    std::optional<FieldElem<Int>> Y = sqrt_.Sqrt(rhs);
+    if (!Y) {
+        return std::nullopt;
+    }
+    Int y = Y->GetVal();
+    if (static_cast<bool>(LimbOf(y, 0) & 1) != odd) {
+        if (Y->IsZero()) {
+            return std::nullopt;
+        }
+        y = (-*Y).GetVal();
+    }
+    return ctx_->Point(x, y);
+}
+
+template <class Int>
+void PointCodec<Int>::EncodeAll(const std::vector<ECPoint<Int>>& points, PointFormat format,
+                                uint8_t* out) const {
+    size_t size = Size(format);
+    for (const auto& P : points) {
+        Encode(P, format, out);
+        out += size;
+    }
+}
+
+template <class Int>
+std::vector<uint8_t> PointCodec<Int>::EncodeAll(const std::vector<ECPoint<Int>>& points,
+                                                PointFormat format) const {
+    std::vector<uint8_t> bytes(points.size() * Size(format));
+    EncodeAll(points, format, bytes.data());
+    return bytes;
+}
+
+template <class Int>
+bool PointCodec<Int>::DecodeAll(const uint8_t* in, size_t n, PointFormat format,
+                                std::vector<ECPoint<Int>>& points) const {
+    size_t size = Size(format);
+    std::vector<uint64_t> limbs;
+    points.reserve(points.size() + n);
+    for (size_t i = 0; i < n; ++i) {
+        std::optional<ECPoint<Int>> P = Decode(in + i * size, format, limbs);
+        if (!P) {
+            return false;
+        }
+        points.push_back(*P);
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <discrete_logarithm/tonelli_shanks.hpp>
+#include <elliptic_curve/ec_point.hpp>
+#include <elliptic_curve/field.hpp>
+
+// n random affine points of ctx sharing one SqrtContext: x is drawn below p (below 2^63 for
+// wider primes) until x^3 + ax + b is a square, y is either of its roots
+template <class Int>
+std::vector<ECPoint<Int>> RandomPoints(const CurveContext<Int>& ctx, size_t n, std::mt19937& gen) {
+    const EllipticCurve<Int>& ec = ctx.Curve();
+    const PrimeField<Int>& field = ctx.Field();
+    SqrtContext<Int> sqrt(field);
+    FieldElem<Int> b(ec.B(), field);
+    int64_t bound = BitLengthOf(ec.Prime()) < 64 ? static_cast<int64_t>(LimbOf(ec.Prime(), 0)) - 1
+                                                 : std::numeric_limits<int64_t>::max();
+    std::uniform_int_distribution<int64_t> dist(0, bound);
+
+    std::vector<ECPoint<Int>> points;
+    points.reserve(n);
+    while (points.size() < n) {
+        FieldElem<Int> x(Int{dist(gen)}, field);
+        std::optional<FieldElem<Int>> y = sqrt.Sqrt(x * x * x + ctx.A() * x + b);
+        if (!y) {
+            continue;
+        }
+        if (gen() & 1) {
+            *y = -*y;
+        }
+        points.push_back(ctx.Point(x.GetVal(), y->GetVal()));
+    }
+    return points;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+// C++17 stand-in for std::stop_token: a token sees the RequestStop() of the source it came from,
+// a default-constructed token never stops
+class StopToken {
+public:
+    StopToken() = default;
+
+    bool StopRequested() const {
+        return flag_ && flag_->load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class StopSource;
+
+    explicit StopToken(std::shared_ptr<const std::atomic<bool>> flag) : flag_{std::move(flag)} {
+    }
+
+    std::shared_ptr<const std::atomic<bool>> flag_;
+};
+
+class StopSource {
+public:
+    StopSource() : flag_{std::make_shared<std::atomic<bool>>(false)} {
+    }
+
+    StopToken GetToken() const {
+        return StopToken(flag_);
+    }
+
+    void RequestStop() {
+        flag_->store(true, std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
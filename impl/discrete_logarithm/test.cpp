@@ -1,9 +1,32 @@
 #include <gtest/gtest.h>
 
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <discrete_logarithm/batched_dl_finder.hpp>
+#include <discrete_logarithm/bsgs.hpp>
+#include <discrete_logarithm/distributed.hpp>
 #include <discrete_logarithm/dl_finder.hpp>
+#include <discrete_logarithm/dp_store.hpp>
+#include <discrete_logarithm/multi_target_finder.hpp>
+#include <discrete_logarithm/pohlig_hellman.hpp>
+#include <discrete_logarithm/point_codec.hpp>
+#include <discrete_logarithm/random_points.hpp>
 #include <discrete_logarithm/tonelli_shanks.hpp>
 #include <elliptic_curve/ec_point.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 #include <random>
 
@@ -113,21 +136,177 @@ TEST(TonelliShanks, Simple) {
     }
 }
 
+template <class Int>
+void CheckSqrtContext(int64_t prime) {
+    PrimeField<Int> field(Int{prime});
+    SqrtContext<Int> ctx(field);
+    std::mt19937 rng(prime);
+    std::uniform_int_distribution<int64_t> dist(0, prime - 1);
+    int64_t count = std::min<int64_t>(prime, 200);
+    for (int64_t k = 0; k < count; ++k) {
+        int64_t v = prime <= 200 ? k : dist(rng);
+        FieldElem<Int> a(Int{v}, field);
+        FieldElem<Int> square = a * a;
+        std::optional<FieldElem<Int>> r = ctx.Sqrt(square);
+        ASSERT_TRUE(r.has_value()) << prime << " " << v;
+        EXPECT_EQ(*r * *r, square);
+        EXPECT_TRUE(ctx.IsSquare(square));
+        // the non-residues are the squares times any non-residue
+        std::optional<FieldElem<Int>> s = ctx.Sqrt(a);
+        EXPECT_EQ(s.has_value(), ctx.IsSquare(a));
+        if (s) {
+            EXPECT_EQ(*s * *s, a);
+        }
+    }
+}
+
+TEST(SqrtContext, AllResidueClasses) {
+    // 3 mod 4, 5 mod 8 (Atkin), 1 mod 8 with s = 3, 4, 5, 7 and the benchmark primes
+    std::vector<int64_t> primes{3,   7,   5,   13,  29,   41,           17,
+                                97,  193, 257, 7681, 1099511627791, 281474976710677,
+                                72057594037928017};
+    for (int64_t p : primes) {
+        CheckSqrtContext<int64_t>(p);
+        CheckSqrtContext<LongInt>(p);
+        CheckSqrtContext<FixedInt<2>>(p);
+    }
+}
+
+TEST(SqrtContext, NonResidues) {
+    PrimeField<int64_t> field(72057594037928017);
+    SqrtContext<int64_t> ctx(field);
+    int non_residues = 0;
+    for (int64_t v = 1; v <= 1000; ++v) {
+        FieldElem<int64_t> a(v, field);
+        bool euler = LegendreSymbol<LongInt>(LongInt{v}, LongInt{72057594037928017}) == LongInt{1};
+        EXPECT_EQ(ctx.Sqrt(a).has_value(), euler);
+        non_residues += !euler;
+    }
+    EXPECT_GT(non_residues, 400);
+}
+
+TEST(ModExp, SlidingWindow) {
+    std::mt19937 rng(7);
+    LongInt mod{1099511627791};
+    for (int i = 0; i < 200; ++i) {
+        int64_t base = rng() % 1099511627791;
+        int64_t exp = i < 100 ? i : static_cast<int64_t>(rng() >> 1) << 20 | i;
+        LongInt expected{1};
+        for (int64_t e = exp, b = base; e > 0; e >>= 1) {
+            if (e & 1) {
+                expected = expected * LongInt{b} % mod;
+            }
+            b = (LongInt{b} * LongInt{b} % mod).NarrowToInt();
+        }
+        EXPECT_EQ(ModExp(LongInt{base}, LongInt{exp}, mod), expected);
+    }
+}
+
 static std::mt19937 gen(42);
 
 template <class Int>
-ECPoint<Int> GetRandomPoint(const EllipticCurve<Int>& ec, int64_t p) {
-    std::uniform_int_distribution<int64_t> dist(1, p - 1);
-    Int x, y;
-    do {
-        x = Int{dist(gen)};
-        FieldElem<Int> X(x);
-        FieldElem<Int> S = X * X * X + FieldElem(ec.A()) * X + FieldElem(ec.B());
-        y = TonelliShanks(S.GetVal(), ec.Prime());
-    } while (y == Int{-1});
-    assert((y * y) % Int{p} == (x * x * x + ec.A() * x + ec.B()) % Int{p});
-    ECPoint P(x, y);
-    return P;
+ECPoint<Int> GetRandomPoint(const CurveContext<Int>& ctx) {
+    return RandomPoints(ctx, 1, gen)[0];
+}
+
+// a random point of the default curve, which SetEllipticCurve sets
+template <class Int>
+ECPoint<Int> GetRandomPoint() {
+    return GetRandomPoint(ECPoint<Int>().Context());
+}
+
+TEST(RandomPoints, OnCurve) {
+    std::vector<std::array<int64_t, 3>> curves{{97, 26, 44},
+                                    {1099511627791, 490064540513, 170079681745},
+                                    {72057594037928017, 15222514519776677, 7110318376978981}};
+    for (const auto& [p, a, b] : curves) {
+        EllipticCurve<LongInt> ec(LongInt{a}, LongInt{b}, LongInt{p}, LongInt{0});
+        CurveContext<LongInt> ctx(ec);
+        std::vector<ECPoint<LongInt>> points = RandomPoints(ctx, 64, gen);
+        ASSERT_EQ(points.size(), 64u);
+        std::unordered_set<ECPoint<LongInt>> distinct(points.begin(), points.end());
+        EXPECT_GT(distinct.size(), 32u);
+        for (const auto& P : points) {
+            LongInt x = P.X();
+            LongInt y = P.Y();
+            LongInt rhs = x * x % LongInt{p} * x + LongInt{a} * x + LongInt{b};
+            EXPECT_EQ(y * y % LongInt{p}, rhs % LongInt{p});
+        }
+    }
+}
+
+template <class Int>
+void CheckPointCodec(const std::array<int64_t, 3>& curve) {
+    auto [p, a, b] = curve;
+    EllipticCurve<Int> ec(Int{a}, Int{b}, Int{p}, Int{0});
+    CurveContext<Int> ctx(ec);
+    PointCodec<Int> codec(ctx);
+    std::vector<ECPoint<Int>> points = RandomPoints(ctx, 64, gen);
+    points.push_back(ECPoint<Int>(ctx));
+    for (auto format : {PointFormat::kUncompressed, PointFormat::kCompressed}) {
+        std::vector<uint8_t> bytes = codec.EncodeAll(points, format);
+        ASSERT_EQ(bytes.size(), points.size() * codec.Size(format));
+        std::vector<ECPoint<Int>> decoded;
+        ASSERT_TRUE(codec.DecodeAll(bytes.data(), points.size(), format, decoded));
+        EXPECT_EQ(decoded, points);
+        for (size_t i = 0; i < points.size(); ++i) {
+            std::optional<ECPoint<Int>> P = codec.Decode(bytes.data() + i * codec.Size(format),
+                                                         format);
+            ASSERT_TRUE(P.has_value());
+            EXPECT_EQ(*P, points[i]);
+        }
+    }
+}
+
+TEST(PointCodec, RoundTrip) {
+    // bit lengths 7, 41 and 57, and 48 for 2^48 - 59 with the parity bit in a byte of its own
+    std::vector<std::array<int64_t, 3>> curves{{97, 26, 44},
+                                               {1099511627791, 490064540513, 170079681745},
+                                               {72057594037928017, 15222514519776677, 7},
+                                               {281474976710597, 3, 7}};
+    for (const auto& curve : curves) {
+        CheckPointCodec<int64_t>(curve);
+        CheckPointCodec<FixedInt<2>>(curve);
+        CheckPointCodec<LongInt>(curve);
+    }
+}
+
+TEST(PointCodec, SizeAndInvalidEncodings) {
+    EllipticCurve<LongInt> ec(LongInt{490064540513}, LongInt{170079681745},
+                              LongInt{1099511627791}, LongInt{1099513257113});
+    CurveContext<LongInt> ctx(ec);
+    PointCodec<LongInt> codec(ctx);
+    EXPECT_EQ(codec.Size(PointFormat::kUncompressed), 12u);
+    EXPECT_EQ(codec.Size(PointFormat::kCompressed), 6u);
+    EXPECT_LT(2 * codec.Size(PointFormat::kUncompressed), sizeof(ECPoint<LongInt>));
+
+    ECPoint<LongInt> P = RandomPoints(ctx, 1, gen)[0];
+    uint8_t bytes[12];
+    codec.Encode(P, PointFormat::kUncompressed, bytes);
+    bytes[6] ^= 1;  // y off the curve
+    EXPECT_FALSE(codec.Decode(bytes, PointFormat::kUncompressed).has_value());
+
+    // x = p is not a coordinate, and an x without a square root has no point
+    std::vector<uint8_t> encoded(6, 0);
+    for (size_t k = 0; k < 6; ++k) {
+        encoded[k] = static_cast<uint8_t>(1099511627791 >> (8 * k));
+    }
+    EXPECT_FALSE(codec.Decode(encoded.data(), PointFormat::kCompressed).has_value());
+    SqrtContext<LongInt> sqrt(ctx.Field());
+    int64_t x = 1;
+    while (true) {
+        FieldElem<LongInt> X(LongInt{x}, ctx.Field());
+        if (!sqrt.IsSquare(X * X * X + ctx.A() * X +
+                           FieldElem<LongInt>(ec.B(), ctx.Field()))) {
+            break;
+        }
+        ++x;
+    }
+    std::fill(encoded.begin(), encoded.end(), 0);
+    encoded[0] = static_cast<uint8_t>(x);
+    EXPECT_FALSE(codec.Decode(encoded.data(), PointFormat::kCompressed).has_value());
+    std::vector<ECPoint<LongInt>> decoded;
+    EXPECT_FALSE(codec.DecodeAll(encoded.data(), 1, PointFormat::kCompressed, decoded));
 }
 
 TEST(DL_ECPoint, SmallPrimeRandom) {
@@ -136,8 +315,8 @@ TEST(DL_ECPoint, SmallPrimeRandom) {
     EllipticCurve<int64_t> ec(26, 44, prime, group_order);
     ECPoint<int64_t>::SetEllipticCurve(ec);
     for (int i = 1; i < 1000; ++i) {
-        ECPoint<int64_t> P = GetRandomPoint(ec, prime);
-        ECPoint<int64_t> Q = GetRandomPoint(ec, prime);
+        ECPoint<int64_t> P = GetRandomPoint<int64_t>();
+        ECPoint<int64_t> Q = GetRandomPoint<int64_t>();
         DiscreteLogarithmFinder<ECPoint<int64_t>, int64_t> dl_finder(P, Q, group_order);
         auto res = dl_finder.Find();
         ASSERT_EQ(P.Power(res), Q);
@@ -150,8 +329,8 @@ TEST(DL_ECPoint, SmallPrimeLongInt) {
     EllipticCurve<LongInt> ec(LongInt(26), LongInt(44), LongInt(prime), LongInt(group_order));
     ECPoint<LongInt>::SetEllipticCurve(ec);
     for (int i = 1; i < 1000; ++i) {
-        ECPoint<LongInt> P = GetRandomPoint(ec, prime);
-        ECPoint<LongInt> Q = GetRandomPoint(ec, prime);
+        ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+        ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
         DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order);
         auto res = dl_finder.Find();
         ASSERT_EQ(P.Power(res), Q);
@@ -164,22 +343,816 @@ TEST(DL_ECPoint, MediumPrimeLongInt) {
     EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
     ECPoint<LongInt>::SetEllipticCurve(ec);
     for (int i = 1; i < 1000; ++i) {
-        ECPoint<LongInt> P = GetRandomPoint(ec, prime);
-        ECPoint<LongInt> Q = GetRandomPoint(ec, prime);
+        ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+        ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
         DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order);
         auto res = dl_finder.Find();
         ASSERT_EQ(P.Power(res), Q);
     }
 }
 
+TEST(DL_ECPoint, MediumPrimeFixedInt) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<FixedInt<2>> ec(149, 449, prime, group_order);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec);
+    for (int i = 1; i < 1000; ++i) {
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        DiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>> dl_finder(P, Q, group_order);
+        auto res = dl_finder.Find();
+        ASSERT_EQ(P.Power(res), Q);
+    }
+}
+
+TEST(DL_ECPoint, BatchedWalks) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<FixedInt<2>> ec(149, 449, prime, group_order);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec);
+    for (size_t batch_size : {1, 8, 64}) {
+        for (int i = 0; i < 50; ++i) {
+            ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+            ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+            BatchedDiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>> dl_finder(
+                P, Q, group_order, batch_size);
+            auto res = dl_finder.Find();
+            ASSERT_EQ(P.Power(res), Q);
+            EXPECT_GT(dl_finder.Additions(), 0);
+        }
+    }
+}
+
+TEST(DL_ECPoint, BatchedFindConcurrent) {
+    // finders in different threads draw their restarts from their own generators
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<FixedInt<2>> ec(149, 449, prime, group_order);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec);
+    std::vector<std::pair<ECPoint<FixedInt<2>>, ECPoint<FixedInt<2>>>> problems;
+    for (int i = 0; i < 40; ++i) {
+        problems.emplace_back(GetRandomPoint<FixedInt<2>>(), GetRandomPoint<FixedInt<2>>());
+    }
+    std::vector<FixedInt<2>> results(problems.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < problems.size(); i += 4) {
+                BatchedDiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>> dl_finder(
+                    problems[i].first, problems[i].second, group_order, 8);
+                results[i] = dl_finder.Find();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < problems.size(); ++i) {
+        EXPECT_EQ(problems[i].first.Power(results[i]), problems[i].second);
+    }
+}
+
+// mean number of steps until the walk revisits a point (tail + cycle), relative to the
+// sqrt(pi * q / 2) expected from a random map
+template <class Int>
+double MeanStepsToCollision(int64_t q, WalkOptions options, int samples) {
+    std::mt19937 walk_gen(7);
+    std::uniform_int_distribution<int64_t> dist(0, q - 1);
+    int64_t total = 0;
+    for (int i = 0; i < samples; ++i) {
+        ECPoint<Int> alpha = GetRandomPoint<Int>();
+        ECPoint<Int> beta = GetRandomPoint<Int>();
+        RhoWalk<ECPoint<Int>, Int> walk(alpha, beta, q, options, walk_gen);
+        Int a{dist(walk_gen)};
+        Int b{dist(walk_gen)};
+        WalkTriple<ECPoint<Int>, Int> t{alpha.Power(a) + beta.Power(b), a, b};
+        std::unordered_set<ECPoint<Int>> visited;
+        while (visited.insert(t.x).second) {
+            t = walk.Next(t);
+        }
+        total += visited.size();
+    }
+    return total / (samples * std::sqrt(M_PI * q / 2));
+}
+
+TEST(DL_Walk, DistinguishedBits) {
+    EXPECT_TRUE(IsDistinguished(5 + 7 * 64, 7, 6));
+    EXPECT_FALSE(IsDistinguished(5 + 7 * 32, 7, 6));
+    EXPECT_TRUE(IsDistinguished(12345, 7, 0));
+    // dp_bits beyond the width of the hash require all bits above the partition to be zero
+    for (int dp_bits : {63, 64, 65, 1000}) {
+        EXPECT_TRUE(IsDistinguished(6, 7, dp_bits));
+        EXPECT_FALSE(IsDistinguished(size_t{1} << 62, 7, dp_bits));
+    }
+    EXPECT_EQ(MaxWalkLength(2), 80);
+    EXPECT_GT(MaxWalkLength(64), 0);
+    EXPECT_EQ(MaxWalkLength(64), MaxWalkLength(1000));
+}
+
+TEST(DL_Walk, StepsToCollision) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<int64_t> ec(149, 449, prime, group_order);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    double pollard =
+        MeanStepsToCollision<int64_t>(group_order, WalkOptions::ThreePartition(), 2000);
+    EXPECT_LT(pollard, 1.5) << "3-partition";
+    for (int r : {16, 20, 32}) {
+        double adding = MeanStepsToCollision<int64_t>(group_order, WalkOptions::Adding(r), 2000);
+        EXPECT_GT(adding, 0.9) << r << "-adding";
+        EXPECT_LT(adding, 1.1) << r << "-adding";
+        double mixed = MeanStepsToCollision<int64_t>(group_order, WalkOptions::Mixed(r, 4), 2000);
+        EXPECT_GT(mixed, 0.9) << r << "+4 mixed";
+        EXPECT_LT(mixed, 1.1) << r << "+4 mixed";
+    }
+}
+
+TEST(DL_Walk, FindWithAddingWalks) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<int64_t> ec(149, 449, prime, group_order);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    for (auto options : {WalkOptions::Adding(16), WalkOptions::Adding(20), WalkOptions::Adding(32),
+                         WalkOptions::Mixed(20, 4)}) {
+        for (int i = 0; i < 100; ++i) {
+            ECPoint<int64_t> P = GetRandomPoint<int64_t>();
+            ECPoint<int64_t> Q = GetRandomPoint<int64_t>();
+            DiscreteLogarithmFinder<ECPoint<int64_t>, int64_t> dl_finder(P, Q, group_order,
+                                                                         options);
+            auto res = dl_finder.Find();
+            ASSERT_EQ(P.Power(res), Q);
+        }
+    }
+}
+
+TEST(DL_MultiTarget, ReusesDistinguishedPoints) {
+    int64_t prime = 1048583;
+    int64_t group_order = 1048129;
+    EllipticCurve<int64_t> ec(4417, 934045, prime, group_order);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    ECPoint<int64_t> alpha = GetRandomPoint<int64_t>();
+    std::uniform_int_distribution<int64_t> dist(1, group_order - 1);
+    const size_t targets = 200;
+    std::vector<int64_t> logs;
+    std::vector<ECPoint<int64_t>> betas;
+    for (size_t i = 0; i < targets; ++i) {
+        logs.push_back(dist(gen));
+        betas.push_back(alpha.Power(logs.back()));
+    }
+
+    MultiTargetDiscreteLogarithmFinder<ECPoint<int64_t>, int64_t> finder(alpha, group_order, 8, 3);
+    uint64_t first = 0;
+    uint64_t last = 0;
+    for (size_t i = 0; i < targets; ++i) {
+        ASSERT_EQ(finder.Find(betas[i]), logs[i]);
+        // the first and the last quarter of the targets
+        if (i < targets / 4) {
+            first += finder.LastAdditions();
+        } else if (i >= targets * 3 / 4) {
+            last += finder.LastAdditions();
+        }
+    }
+    EXPECT_EQ(finder.Solved(), targets);
+    // about sqrt(2 m q) in total against m sqrt(pi q / 2) for independent solves
+    double independent = targets * std::sqrt(M_PI * group_order / 2);
+    EXPECT_LT(finder.Additions(), independent / 4) << finder.Additions() / independent;
+    EXPECT_LT(last, first);
+}
+
+TEST(DL_MultiTarget, NegationMapAndDoublings) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<int64_t> ec(149, 449, prime, group_order);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    ECPoint<int64_t> alpha = GetRandomPoint<int64_t>();
+    std::vector<int64_t> logs;
+    std::vector<ECPoint<int64_t>> betas;
+    for (int64_t i = 0; i < 100; ++i) {
+        logs.push_back(i * 71 % group_order);
+        betas.push_back(alpha.Power(logs.back()));
+    }
+    for (auto walk : {WalkOptions::Mixed(20, 4), WalkOptions::Adding(20).WithNegationMap(),
+                      WalkOptions::ThreePartition()}) {
+        MultiTargetDiscreteLogarithmFinder<ECPoint<int64_t>, int64_t> finder(alpha, group_order,
+                                                                             4, 2, walk);
+        EXPECT_EQ(finder.FindAll(betas), logs);
+    }
+}
+
+TEST(DL_ECPoint, CycleDetection) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<int64_t> ec(149, 449, prime, group_order);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    for (auto detection :
+         {CycleDetection::kFloyd, CycleDetection::kBrent, CycleDetection::kNivasch}) {
+        for (auto walk : {WalkOptions::ThreePartition(), WalkOptions::Adding(20)}) {
+            for (int i = 0; i < 100; ++i) {
+                ECPoint<int64_t> P = GetRandomPoint<int64_t>();
+                ECPoint<int64_t> Q = GetRandomPoint<int64_t>();
+                DiscreteLogarithmFinder<ECPoint<int64_t>, int64_t> dl_finder(P, Q, group_order,
+                                                                             walk, detection);
+                auto res = dl_finder.Find();
+                ASSERT_EQ(P.Power(res), Q);
+                EXPECT_GT(dl_finder.Evaluations(), 0);
+            }
+        }
+    }
+}
+
+TEST(DL_CyclicGroup, CycleDetection) {
+    CyclicGroupElem::SetMod(101);
+    CyclicGroupElem alpha(11);
+    CyclicGroupElem beta(29);
+    for (auto detection : {CycleDetection::kBrent, CycleDetection::kNivasch}) {
+        DiscreteLogarithmFinder<CyclicGroupElem, int64_t> dl_finder(
+            alpha, beta, 101, WalkOptions::ThreePartition(), detection);
+        EXPECT_EQ(dl_finder.Find(), SolveEquation<int64_t>(29, 11, 101));
+    }
+}
+
+TEST(DL_ECPoint, NegationMap) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<FixedInt<2>> ec(149, 449, prime, group_order);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec);
+    using Finder = DiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>>;
+    uint64_t plain = 0;
+    uint64_t negation = 0;
+    for (int i = 0; i < 500; ++i) {
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        Finder plain_finder(P, Q, group_order, WalkOptions::Adding(32), CycleDetection::kBrent);
+        ASSERT_EQ(P.Power(plain_finder.Find()), Q);
+        plain += plain_finder.Evaluations();
+        Finder finder(P, Q, group_order, WalkOptions::Adding(32).WithNegationMap(),
+                      CycleDetection::kBrent);
+        ASSERT_EQ(P.Power(finder.Find()), Q);
+        negation += finder.Evaluations();
+    }
+    EXPECT_LT(negation, plain * 0.85) << double(negation) / plain;
+
+    for (int i = 0; i < 20; ++i) {
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        Finder finder(P, Q, group_order, WalkOptions::Adding(20).WithNegationMap());
+        ASSERT_EQ(P.Power(finder.ParallelFind(2, 2)), Q);
+    }
+
+    // the batched walks redo the lanes that land in their own slot, retries and escapes count
+    using Batched = BatchedDiscreteLogarithmFinder<ECPoint<FixedInt<2>>, FixedInt<2>>;
+    plain = 0;
+    negation = 0;
+    for (int i = 0; i < 500; ++i) {
+        ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+        ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+        Batched plain_finder(P, Q, group_order, 4, 2, WalkOptions::Adding(32));
+        ASSERT_EQ(P.Power(plain_finder.Find()), Q);
+        plain += plain_finder.Additions();
+        Batched finder(P, Q, group_order, 4, 2, WalkOptions::Adding(32).WithNegationMap());
+        ASSERT_EQ(P.Power(finder.Find()), Q);
+        negation += finder.Additions();
+    }
+    EXPECT_LT(negation, plain * 0.85) << double(negation) / plain;
+}
+
+// few slots in a group of 139 make fruitless cycles through the neutral element and cycles of
+// escapes only, the single walk has to get out of both
+TEST(DL_ECPoint, NegationMapSmallGroup) {
+    EllipticCurve<LongInt> ec(LongInt(43), LongInt(71), LongInt(149), LongInt(139));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (int slots : {2, 4}) {
+        for (auto detection :
+             {CycleDetection::kFloyd, CycleDetection::kBrent, CycleDetection::kNivasch}) {
+            for (int i = 0; i < 200; ++i) {
+                ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+                ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+                DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> finder(
+                    P, Q, 139, WalkOptions::Adding(slots).WithNegationMap(), detection);
+                ASSERT_EQ(P.Power(finder.Find()), Q);
+            }
+        }
+    }
+}
+
+TEST(DL_ECPoint, ParallelFind) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (size_t threads : {1, 2, 4}) {
+        for (int i = 0; i < 20; ++i) {
+            ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+            ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+            DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order,
+                                                                         WalkOptions::Adding(20));
+            auto res = dl_finder.ParallelFind(threads, 2);
+            ASSERT_EQ(P.Power(res), Q);
+        }
+    }
+    DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(
+        GetRandomPoint<LongInt>(), GetRandomPoint<LongInt>(), group_order, WalkOptions::Adding(20));
+    EXPECT_THROW(dl_finder.ParallelFind(0), std::invalid_argument);
+}
+
+// the walks share the work: the total evaluations over all threads stay near the single-thread
+// count, so the time to solution drops with the thread count
+TEST(DL_ECPoint, ParallelFindEvaluations) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    const int instances = 300;
+    const int dp_bits = 2;
+    auto mean_evaluations = [&](size_t threads) {
+        uint64_t total = 0;
+        for (int i = 0; i < instances; ++i) {
+            ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+            ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+            DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order,
+                                                                         WalkOptions::Adding(20));
+            EXPECT_EQ(P.Power(dl_finder.ParallelFind(threads, dp_bits)), Q);
+            total += dl_finder.Evaluations();
+        }
+        return double(total) / instances;
+    };
+    double single = mean_evaluations(1);
+    double expected = std::sqrt(M_PI * group_order / 2);
+    EXPECT_GT(single, expected * 0.5) << single;
+    EXPECT_LT(single, expected * 2) << single;
+    for (size_t threads : {2, 4}) {
+        // every walk also runs about 2^dp_bits steps past its last distinguished point
+        double parallel = mean_evaluations(threads);
+        EXPECT_LT(parallel, single * 1.25 + threads * (1 << dp_bits)) << threads << " " << parallel;
+    }
+}
+
+TEST(DL_ECPoint, Observer) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (WalkOptions walk : {WalkOptions::ThreePartition(), WalkOptions::Adding(20)}) {
+        for (int i = 0; i < 20; ++i) {
+            ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+            ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+            DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order, walk);
+            std::vector<FinderStats> reports;
+            dl_finder.SetObserver([&](const FinderStats& stats) { reports.push_back(stats); }, 16);
+            ASSERT_EQ(P.Power(dl_finder.Find()), Q);
+
+            uint64_t steps = dl_finder.Evaluations();
+            ASSERT_EQ(reports.size(), steps / 16 + 1);
+            for (size_t j = 0; j + 1 < reports.size(); ++j) {
+                EXPECT_EQ(reports[j].steps, 16 * (j + 1));
+                EXPECT_LE(reports[j].seconds, reports[j + 1].seconds);
+            }
+            const FinderStats& last = reports.back();
+            EXPECT_EQ(last.steps, steps);
+            EXPECT_EQ(last.additions + last.doublings, steps);
+            EXPECT_EQ(last.inversions, steps);
+            EXPECT_DOUBLE_EQ(last.expected_steps, std::sqrt(M_PI * group_order / 2));
+            EXPECT_GE(last.Eta(), 0);
+            if (walk.pollard) {
+                EXPECT_GT(last.doublings, 0u);
+            } else {
+                EXPECT_EQ(last.doublings, 0u);
+            }
+        }
+    }
+}
+
+TEST(DL_CyclicGroup, Observer) {
+    int n = 10007;
+    CyclicGroupElem::SetMod(n);
+    CyclicGroupElem alpha(11);
+    CyclicGroupElem beta(29);
+    DiscreteLogarithmFinder<CyclicGroupElem, int64_t> dl_finder(alpha, beta, n);
+    uint64_t restarts = 0;
+    uint64_t inversions = 1;
+    dl_finder.SetObserver([&](const FinderStats& stats) {
+        restarts = stats.restarts;
+        inversions = stats.inversions;
+    });
+    EXPECT_EQ(dl_finder.Find(), SolveEquation(beta.GetVal(), alpha.GetVal(), n));
+    EXPECT_EQ(inversions, 0u);
+    EXPECT_LE(restarts, 10u);
+}
+
+TEST(DL_ECPoint, FindAsync) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (CycleDetection detection :
+         {CycleDetection::kFloyd, CycleDetection::kBrent, CycleDetection::kNivasch}) {
+        ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+        ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+        DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(
+            P, Q, group_order, WalkOptions::Adding(20), detection);
+        StopSource source;
+        auto result = dl_finder.FindAsync(source.GetToken()).get();
+        ASSERT_EQ(result.status, FindStatus::kSolved);
+        ASSERT_EQ(P.Power(result.logarithm), Q);
+        EXPECT_EQ(result.stats.steps, dl_finder.Evaluations());
+        // an ordinary Find() afterwards is not limited by the async settings
+        ASSERT_EQ(P.Power(dl_finder.Find()), Q);
+    }
+}
+
+TEST(DL_ECPoint, FindAsyncStop) {
+    int64_t prime = 1099511627791;
+    int64_t group_order = 1099513257113;
+    EllipticCurve<LongInt> ec(LongInt{490064540513}, LongInt{170079681745}, LongInt{prime},
+                              LongInt{group_order});
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+    ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+    for (CycleDetection detection :
+         {CycleDetection::kFloyd, CycleDetection::kBrent, CycleDetection::kNivasch}) {
+        DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(
+            P, Q, group_order, WalkOptions::Adding(20), detection);
+
+        StopSource source;
+        auto cancelled = dl_finder.FindAsync(source.GetToken());
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        source.RequestStop();
+        ASSERT_EQ(cancelled.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        auto result = cancelled.get();
+        EXPECT_EQ(result.status, FindStatus::kCancelled);
+        EXPECT_GT(result.stats.steps, 0u);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+        result = dl_finder.FindAsync(StopToken(), deadline, 64).get();
+        EXPECT_EQ(result.status, FindStatus::kTimedOut);
+        EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+        EXPECT_GT(result.stats.steps, 0u);
+        EXPECT_GT(result.stats.Eta(), 0);
+    }
+}
+
+TEST(DistinguishedPointStore, Reopen) {
+    std::string path = (std::filesystem::temp_directory_path() / "dp_store_reopen.bin").string();
+    std::remove(path.c_str());
+    DistinguishedPointStoreParams params{7681, 1, 2, 2, WalkOptions::Adding(20), 5, 3};
+    {
+        DistinguishedPointStore store(path, params);
+        EXPECT_FALSE(store.Resumed());
+        for (int64_t i = 0; i < 10000; ++i) {
+            ASSERT_FALSE(store.Insert(i * 7919, i, 2 * i));
+        }
+        ASSERT_EQ(store.Insert(7919, 5, 5), std::make_pair(int64_t{1}, int64_t{2}));
+        store.SaveWalk(1, 10, 20);
+    }
+
+    params.walk_seed = 6;
+    params.walks = 1;
+    {
+        DistinguishedPointStore store(path, params);
+        EXPECT_TRUE(store.Resumed());
+        EXPECT_EQ(store.Size(), 10000u);
+        EXPECT_EQ(store.Params().walk_seed, 5u);
+        EXPECT_EQ(store.Params().walks, 3u);
+        EXPECT_FALSE(store.LoadWalk(0));
+        EXPECT_EQ(store.LoadWalk(1), std::make_pair(int64_t{10}, int64_t{20}));
+        EXPECT_EQ(store.Insert(9999 * 7919, 0, 0), std::make_pair(int64_t{9999}, int64_t{19998}));
+        EXPECT_THROW(DistinguishedPointStore(path, params), std::runtime_error);
+    }
+
+    // a beta-independent walk is another iteration function
+    params.walk = params.walk.BetaIndependent();
+    EXPECT_THROW(DistinguishedPointStore(path, params), std::runtime_error);
+    params.walk = WalkOptions::Adding(20);
+    params.order = 7727;
+    EXPECT_THROW(DistinguishedPointStore(path, params), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(DL_ECPoint, PersistentFind) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    std::string path = (std::filesystem::temp_directory_path() / "dp_store_find.bin").string();
+    for (size_t threads : {1, 3}) {
+        for (int i = 0; i < 10; ++i) {
+            std::remove(path.c_str());
+            ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+            ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+            // the second finder resumes from the points of the first with another walk count
+            for (size_t run = 0; run < 2; ++run) {
+                DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(
+                    P, Q, group_order, WalkOptions::Adding(20));
+                auto res = dl_finder.PersistentFind(path, threads + run, 2, 16);
+                ASSERT_EQ(P.Power(res), Q);
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(DL_ECPoint, DistributedFind) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (int i = 0; i < 10; ++i) {
+        ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+        ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+        std::vector<pid_t> workers;
+        LongInt res;
+        {
+            DistributedCoordinator<ECPoint<LongInt>, LongInt> coordinator(
+                P, Q, group_order, WalkOptions::Adding(20), 2);
+            for (int w = 0; w < 3; ++w) {
+                pid_t pid = fork();
+                ASSERT_GE(pid, 0);
+                if (pid == 0) {
+                    // a worker that comes after the solution finds the coordinator closed
+                    try {
+                        DistributedWorker<ECPoint<LongInt>, LongInt> worker(P, Q, group_order);
+                        worker.Run("127.0.0.1", coordinator.Port(), 2, 16);
+                    } catch (const std::runtime_error&) {
+                    }
+                    _exit(0);
+                }
+                workers.push_back(pid);
+            }
+            res = coordinator.Run();
+            EXPECT_GE(coordinator.Stats().workers, 1u);
+            EXPECT_GT(coordinator.Stats().points, 0u);
+        }
+        for (pid_t pid : workers) {
+            int status;
+            ASSERT_EQ(waitpid(pid, &status, 0), pid);
+            EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        ASSERT_EQ(P.Power(res), Q);
+    }
+}
+
+TEST(DL_ECPoint, DistributedJobWalkOptions) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+    ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+    WalkOptions walk = WalkOptions::Mixed(16, 4).WithNegationMap().BetaIndependent();
+    DistributedCoordinator<ECPoint<LongInt>, LongInt> coordinator(P, Q, group_order, walk, 3);
+    std::thread server([&coordinator] { EXPECT_EQ(coordinator.Run(), LongInt(-1)); });
+
+    // a worker that leaves right after the job, the coordinator then gives up
+    int fd = ConnectSocket("127.0.0.1", coordinator.Port());
+    DistributedMessage type;
+    std::vector<char> payload;
+    ASSERT_TRUE(ReceiveFrame(fd, type, payload));
+    CloseSocket(fd);
+    server.join();
+    ASSERT_EQ(type, DistributedMessage::kJob);
+    ASSERT_EQ(payload.size(), sizeof(JobMessage));
+    JobMessage job;
+    std::memcpy(&job, payload.data(), sizeof(job));
+    EXPECT_EQ(job.dp_bits, 3);
+    EXPECT_EQ(job.adding_slots, 16);
+    EXPECT_EQ(job.doubling_slots, 4);
+    EXPECT_EQ(job.pollard, 0);
+    EXPECT_EQ(job.negation_map, 1);
+    EXPECT_EQ(job.beta_independent, 1);
+}
+
+TEST(DL_Protocol, FrameSizeLimit) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    std::vector<char> batch(kMaxFramePayload);
+    ASSERT_TRUE(SendFrame(fds[0], DistributedMessage::kBatch, batch.data(), 64));
+    // a header announcing 4 GiB is rejected before anything is allocated
+    FrameHeader huge{static_cast<uint32_t>(DistributedMessage::kBatch), 0xffffffff};
+    ASSERT_EQ(write(fds[0], &huge, sizeof(huge)), static_cast<ssize_t>(sizeof(huge)));
+
+    DistributedMessage type;
+    std::vector<char> payload;
+    ASSERT_TRUE(ReceiveFrame(fds[1], type, payload));
+    EXPECT_EQ(payload.size(), 64u);
+    EXPECT_FALSE(ReceiveFrame(fds[1], type, payload));
+    EXPECT_LE(payload.capacity(), kMaxFramePayload);
+    CloseSocket(fds[0]);
+    CloseSocket(fds[1]);
+}
+
+TEST(DL_ECPoint, DistributedFlushInterval) {
+    // on the 57-bit curve with 2^20 steps per distinguished point the walk finds about a point
+    // a second, the first one has to leave in a batch of its own after flush_interval
+    using Point = ECPoint<FixedInt<2>>;
+    EllipticCurve<FixedInt<2>> ec(FixedInt<2>(15222514519776677), FixedInt<2>(7110318376978981),
+                                  FixedInt<2>(72057594037928017), FixedInt<2>(72057594089783747));
+    Point::SetEllipticCurve(ec);
+    Point P = GetRandomPoint<FixedInt<2>>();
+    Point Q = GetRandomPoint<FixedInt<2>>();
+    int64_t order = 72057594089783747;
+    const auto flush_interval = std::chrono::milliseconds(20);
+
+    uint16_t port = 0;
+    int listen_fd = ListenSocket("127.0.0.1", port);
+    std::thread worker([&] {
+        DistributedWorker<Point, FixedInt<2>> w(P, Q, order);
+        w.Run("127.0.0.1", port, 1, 4, flush_interval);
+    });
+    int fd = AcceptSocket(listen_fd);
+    ASSERT_GE(fd, 0);
+    WalkOptions walk = WalkOptions::Adding(20);
+    auto hash = std::hash<Point>{};
+    JobMessage job{order, hash(P), hash(Q), 20, walk.adding_slots, walk.doubling_slots, 0, 0, 0,
+                   0, 1, 2};
+    ASSERT_TRUE(SendFrame(fd, DistributedMessage::kJob, &job, sizeof(job)));
+
+    DistributedMessage type;
+    std::vector<char> payload;
+    ASSERT_TRUE(ReceiveFrame(fd, type, payload));
+    int64_t received = SteadyNanoseconds();
+    ASSERT_EQ(type, DistributedMessage::kBatch);
+    BatchHeader header;
+    std::memcpy(&header, payload.data(), sizeof(header));
+    size_t count = (payload.size() - sizeof(header)) / sizeof(DistinguishedPointRecord);
+    EXPECT_GE(count, 1u);
+    EXPECT_LT(count, 4u);
+    EXPECT_LT(received - header.first_point_ns,
+              std::chrono::nanoseconds(flush_interval + std::chrono::milliseconds(30)).count());
+
+    SendFrame(fd, DistributedMessage::kStop, nullptr, 0);
+    worker.join();
+    CloseSocket(fd);
+    CloseSocket(listen_fd);
+}
+
+TEST(Factorize, Simple) {
+    using Factors = std::vector<std::pair<int64_t, int>>;
+    EXPECT_EQ(Factorize(1), Factors{});
+    EXPECT_EQ(Factorize(9980), (Factors{{2, 2}, {5, 1}, {499, 1}}));
+    EXPECT_EQ(Factorize(55440), (Factors{{2, 4}, {3, 2}, {5, 1}, {7, 1}, {11, 1}}));
+    EXPECT_EQ(Factorize(2305843009213693951), (Factors{{2305843009213693951, 1}}));
+    EXPECT_EQ(Factorize(998244353LL * 1000000007LL), (Factors{{998244353, 1}, {1000000007, 1}}));
+    EXPECT_EQ(Factorize(2147483647LL * 2147483647LL), (Factors{{2147483647, 2}}));
+}
+
+TEST(DL_CyclicGroup, PohligHellman) {
+    std::mt19937 gen(42);
+    std::vector<int> orders{2, 12, 1024, 2187, 9991, 55440};
+    for (auto n : orders) {
+        CyclicGroupElem::SetMod(n);
+        std::uniform_int_distribution<int> dist(1, n - 1);
+        for (int i = 0; i < 5; ++i) {
+            CyclicGroupElem alpha(dist(gen));
+            while (GCD<int64_t>(alpha.GetVal(), n) != 1) {
+                alpha = CyclicGroupElem(dist(gen));
+            }
+            CyclicGroupElem beta(dist(gen));
+            PohligHellman<CyclicGroupElem, int64_t> solver(alpha, beta, n);
+            EXPECT_EQ(solver.Find(), SolveEquation<int64_t>(beta.GetVal(), alpha.GetVal(), n));
+        }
+    }
+    // beta outside <alpha>: 4 has order 3 modulo 12, 2 has order 97 modulo 194
+    CyclicGroupElem::SetMod(12);
+    EXPECT_EQ((PohligHellman<CyclicGroupElem, int64_t>(4, 5, 3).Find()), -1);
+    CyclicGroupElem::SetMod(194);
+    EXPECT_EQ((PohligHellman<CyclicGroupElem, int64_t>(2, 1, 97).Find()), -1);
+}
+
+TEST(DL_ECPoint, PohligHellman) {
+    // the group of y^2 = x^3 + x + 21 over F_10007 is cyclic of order 9980 = 2^2 * 5 * 499
+    int64_t prime = 10007;
+    int64_t group_order = 9980;
+    EllipticCurve<LongInt> ec(LongInt(1), LongInt(21), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(LongInt(10), LongInt(2856));
+    std::uniform_int_distribution<int64_t> dist(0, group_order - 1);
+    for (int i = 0; i < 50; ++i) {
+        LongInt x{dist(gen)};
+        ECPoint<LongInt> Q = P.Power(x);
+        PohligHellman<ECPoint<LongInt>, LongInt> solver(P, Q, group_order);
+        EXPECT_EQ(solver.Find(), x);
+    }
+    // P generates the whole group, so it is not a power of P^20 of order 499
+    PohligHellman<ECPoint<LongInt>, LongInt> solver(P.Power(LongInt(20)), P, 499);
+    EXPECT_EQ(solver.Find(), LongInt(-1));
+}
+
+TEST(DL_CyclicGroup, BabyStepGiantStep) {
+    std::mt19937 gen(42);
+    std::vector<int> orders{2, 12, 97, 1024, 9991};
+    for (auto n : orders) {
+        CyclicGroupElem::SetMod(n);
+        std::uniform_int_distribution<int> dist(1, n - 1);
+        for (int i = 0; i < 5; ++i) {
+            CyclicGroupElem alpha(dist(gen));
+            while (GCD<int64_t>(alpha.GetVal(), n) != 1) {
+                alpha = CyclicGroupElem(dist(gen));
+            }
+            CyclicGroupElem beta(dist(gen));
+            BabyStepGiantStep<CyclicGroupElem, int64_t> bsgs(alpha, beta, n);
+            EXPECT_EQ(bsgs.Find(), SolveEquation<int64_t>(beta.GetVal(), alpha.GetVal(), n));
+        }
+    }
+    CyclicGroupElem::SetMod(12);
+    BabyStepGiantStep<CyclicGroupElem, int64_t> bsgs(CyclicGroupElem(4), CyclicGroupElem(5), 12);
+    EXPECT_EQ(bsgs.Find(), -1);
+}
+
+TEST(DL_ECPoint, BabyStepGiantStep) {
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<LongInt> ec(LongInt(149), LongInt(449), LongInt(prime), LongInt(group_order));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    for (size_t budget : {kDefaultBabyStepBudget, size_t{256}}) {
+        for (int i = 0; i < 50; ++i) {
+            ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+            ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
+            BabyStepGiantStep<ECPoint<LongInt>, LongInt> bsgs(P, Q, group_order, budget);
+            EXPECT_EQ(bsgs.BabySteps(), budget == 256 ? 16 : 88);
+            EXPECT_LE(BabyStepTable::Bytes(bsgs.BabySteps()), budget);
+            auto res = bsgs.Find();
+            ASSERT_EQ(P.Power(res), Q);
+            ASSERT_TRUE(res >= 0 && res < group_order);
+        }
+    }
+}
+
+TEST(DL_ECPoint, SolveDiscreteLogarithm) {
+    EXPECT_EQ(ChooseDiscreteLogarithmMethod(7681, kDefaultBabyStepBudget),
+              DiscreteLogarithmMethod::kBabyStepGiantStep);
+    EXPECT_EQ(ChooseDiscreteLogarithmMethod(int64_t{1} << 40, kDefaultBabyStepBudget),
+              DiscreteLogarithmMethod::kBabyStepGiantStep);
+    EXPECT_EQ(ChooseDiscreteLogarithmMethod(int64_t{1} << 44, kDefaultBabyStepBudget),
+              DiscreteLogarithmMethod::kRho);
+    EXPECT_EQ(ChooseDiscreteLogarithmMethod(7681, 1024), DiscreteLogarithmMethod::kRho);
+
+    int64_t prime = 7727;
+    int64_t group_order = 7681;
+    EllipticCurve<FixedInt<2>> ec(149, 449, prime, group_order);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec);
+    for (size_t budget : {kDefaultBabyStepBudget, size_t{1024}}) {
+        for (int i = 0; i < 20; ++i) {
+            ECPoint<FixedInt<2>> P = GetRandomPoint<FixedInt<2>>();
+            ECPoint<FixedInt<2>> Q = GetRandomPoint<FixedInt<2>>();
+            auto res = SolveDiscreteLogarithm<ECPoint<FixedInt<2>>, FixedInt<2>>(P, Q, group_order,
+                                                                                 budget);
+            ASSERT_EQ(P.Power(res), Q);
+        }
+    }
+}
+
+TEST(DL_ECPoint, ConcurrentCurves) {
+    struct Curve {
+        int64_t a, b, p, q;
+    };
+    std::vector<Curve> curves{{26, 44, 97, 101}, {149, 449, 7727, 7681}, {1, 21, 10007, 9980}};
+    std::vector<std::unique_ptr<CurveContext<LongInt>>> contexts;
+    std::vector<std::vector<std::pair<ECPoint<LongInt>, ECPoint<LongInt>>>> tasks(curves.size());
+    for (size_t i = 0; i < curves.size(); ++i) {
+        const Curve& c = curves[i];
+        contexts.push_back(std::make_unique<CurveContext<LongInt>>(EllipticCurve<LongInt>(
+            LongInt(c.a), LongInt(c.b), LongInt(c.p), LongInt(c.q))));
+        ECPoint<LongInt> P = i == 2 ? contexts[i]->Point(LongInt(10), LongInt(2856))
+                                    : GetRandomPoint(*contexts[i]);
+        for (int j = 0; j < 20; ++j) {
+            tasks[i].emplace_back(P, P.Power(LongInt{int64_t(gen() % c.q)}));
+        }
+    }
+
+    // another curve as the process-wide default must not disturb the contexts
+    EllipticCurve<LongInt> ec(LongInt(43), LongInt(71), LongInt(149), LongInt(139));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+
+    std::vector<int> solved(curves.size(), 0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < curves.size(); ++i) {
+        workers.emplace_back([&, i] {
+            for (auto& [P, Q] : tasks[i]) {
+                LongInt res = curves[i].q == 9980
+                                  ? PohligHellman<ECPoint<LongInt>, LongInt>(P, Q, 9980).Find()
+                                  : DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt>(
+                                        P, Q, curves[i].q, WalkOptions::Adding(20))
+                                        .Find();
+                solved[i] += (P.Power(res) == Q);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (size_t i = 0; i < curves.size(); ++i) {
+        EXPECT_EQ(solved[i], 20);
+    }
+}
+
 TEST(DL_ECPoint, BigPrimeRandom) {
     int64_t prime = 1099511627791;
     int64_t group_order = 1099513257113;
     EllipticCurve<LongInt> ec(LongInt{490064540513}, LongInt{170079681745}, LongInt{prime},
                               LongInt{group_order});
     ECPoint<LongInt>::SetEllipticCurve(ec);
-    ECPoint<LongInt> P = GetRandomPoint(ec, prime);
-    ECPoint<LongInt> Q = GetRandomPoint(ec, prime);
+    ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+    ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
     DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, group_order);
     auto res = dl_finder.Find();
     EXPECT_EQ(P.Power(res), Q);
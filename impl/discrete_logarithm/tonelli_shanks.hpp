@@ -1,72 +1,207 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <elliptic_curve/field.hpp>
+
+// bits of a non-negative exponent, least significant first
 template <class Int>
-Int ModExp(Int base, Int exp, Int mod) {
-    Int result = 1;
-    base = base % mod;
+std::vector<uint8_t> ExponentBits(Int exp) {
+    std::vector<uint8_t> bits;
     while (exp > 0) {
-        if (exp % Int{2} == Int{1})
-            result = (result * base) % mod;
-        exp = exp / Int{2};   
-        base = (base * base) % mod;  
+        bits.push_back(exp % Int{2} == Int{1});
+        exp = exp / Int{2};
+    }
+    return bits;
+}
+
+// window width for an exponent of the given bit length, 2^(w - 1) table entries against
+// about length / (w + 1) multiplications
+inline int SlidingWindowWidth(size_t length) {
+    return length <= 24 ? 1 : length <= 80 ? 3 : length <= 240 ? 4 : 5;
+}
+
+// base^exp for the bits of exp by left-to-right sliding windows over the odd powers
+// base, base^3, ..., base^(2^w - 1); mul is the multiplication and one its neutral element
+template <class T, class Mul>
+T SlidingWindowPow(const T& base, const std::vector<uint8_t>& bits, const T& one, Mul mul) {
+    int w = SlidingWindowWidth(bits.size());
+    std::vector<T> odd{base};
+    if (w > 1) {
+        T square = mul(base, base);
+        for (size_t k = 1; k < (size_t{1} << (w - 1)); ++k) {
+            odd.push_back(mul(odd.back(), square));
+        }
+    }
+    T result = one;
+    bool started = false;
+    for (size_t i = bits.size(); i-- > 0;) {
+        if (!bits[i]) {
+            if (started) {
+                result = mul(result, result);
+            }
+            continue;
+        }
+        // the window runs from bit i down to the lowest set bit at most w - 1 below it
+        size_t low = i + 1 >= static_cast<size_t>(w) ? i + 1 - w : 0;
+        while (!bits[low]) {
+            ++low;
+        }
+        size_t value = 0;
+        for (size_t j = i + 1; j-- > low;) {
+            value = value * 2 + bits[j];
+            if (started) {
+                result = mul(result, result);
+            }
+        }
+        result = started ? mul(result, odd[value / 2]) : odd[value / 2];
+        started = true;
+        i = low;
     }
     return result;
 }
 
+template <class Int>
+Int ModExp(Int base, Int exp, Int mod) {
+    base = base % mod;
+    return SlidingWindowPow(base, ExponentBits(exp), Int{1},
+                            [&mod](const Int& x, const Int& y) { return (x * y) % mod; });
+}
+
 template <class Int>
 Int LegendreSymbol(Int a, Int p) {
     Int ls = ModExp(a, (p - Int{1}) / Int{2}, p);
     return (ls == p - Int{1}) ? Int{-1} : ls;
 }
 
-
-// find square root of a modulo p
+// square roots in a PrimeField of odd characteristic p; the exponents are recoded once, so
+// reuse one context for all roots modulo the same prime. p = 3 mod 4 and p = 5 mod 8 (Atkin)
+// take a single exponentiation, otherwise Tonelli-Shanks runs with p - 1 = q 2^s and the
+// non-residue z found once, c = z^q and its squarings c^(2^k) cached
 template <class Int>
-Int TonelliShanks(Int a, Int p) {
-    if (LegendreSymbol(a, p) != Int{1})
-        return Int{-1}; 
+class SqrtContext {
+public:
+    explicit SqrtContext(const PrimeField<Int>& field);
+
+    const PrimeField<Int>& Field() const {
+        return *field_;
+    }
+
+    // r with r * r == a, either of the two roots; nullopt when a is not a square
+    std::optional<FieldElem<Int>> Sqrt(const FieldElem<Int>& a) const;
+
+    // Euler's criterion, true for zero
+    bool IsSquare(const FieldElem<Int>& a) const;
 
-    if (p % Int{4} == Int{3})
-        return ModExp(a, (p + 1) / Int{4}, p);
+private:
+    enum class Method { kThreeModFour, kAtkin, kTonelliShanks };
 
-    Int s = 0;
+    FieldElem<Int> Pow(const FieldElem<Int>& base, const std::vector<uint8_t>& bits) const;
+
+    const PrimeField<Int>* field_;
+    FieldElem<Int> one_;
+    Method method_;
+    std::vector<uint8_t> euler_bits_;  // (p - 1) / 2
+    std::vector<uint8_t> root_bits_;   // (p + 1) / 4, (p - 5) / 8 or (q - 1) / 2 by method_
+    size_t s_ = 0;
+    std::vector<FieldElem<Int>> c_powers_;  // c^(2^k) for k < s
+};
+
+template <class Int>
+SqrtContext<Int>::SqrtContext(const PrimeField<Int>& field)
+    : field_(&field), one_(Int{1}, field) {
+    const Int& p = field.Prime();
+    euler_bits_ = ExponentBits((p - Int{1}) / Int{2});
+    if (p % Int{4} == Int{3}) {
+        method_ = Method::kThreeModFour;
+        root_bits_ = ExponentBits((p + Int{1}) / Int{4});
+        return;
+    }
+    if (p % Int{8} == Int{5}) {
+        method_ = Method::kAtkin;
+        root_bits_ = ExponentBits((p - Int{5}) / Int{8});
+        return;
+    }
+    method_ = Method::kTonelliShanks;
     Int q = p - Int{1};
-    while (q % Int{2} == 0) {
-        q /= Int{2};
-        s += Int{1};
+    while (q % Int{2} == Int{0}) {
+        q = q / Int{2};
+        ++s_;
     }
-
-    Int z = 2;
-    while (LegendreSymbol(z, p) != Int{-1}) {
-        z += Int{1};
+    root_bits_ = ExponentBits((q - Int{1}) / Int{2});
+    FieldElem<Int> z(Int{2}, field);
+    while (IsSquare(z)) {
+        z += one_;
+    }
+    c_powers_.push_back(Pow(z, ExponentBits(q)));
+    for (size_t k = 1; k < s_; ++k) {
+        c_powers_.push_back(c_powers_.back() * c_powers_.back());
     }
+}
 
-    Int m = s;
-    Int c = ModExp(z, q, p);
-    Int t = ModExp(a, q, p);
-    Int r = ModExp(a, (q + 1) / Int{2}, p);
-
-    while (t != 0 && t != 1) {
-        Int i = 0;
-        Int temp = t;
-        while (temp != 1 && i < m) {
-            temp = (temp * temp) % p;
-            i += Int{1};
-        }
+template <class Int>
+FieldElem<Int> SqrtContext<Int>::Pow(const FieldElem<Int>& base,
+                                     const std::vector<uint8_t>& bits) const {
+    return SlidingWindowPow(base, bits, one_,
+                            [](const FieldElem<Int>& x, const FieldElem<Int>& y) { return x * y; });
+}
 
-        Int counter = m - i - Int{1};
-        Int power = 1;
-        while (counter > 0) {
-            counter -= Int{1};
-            power *= Int{2};
+template <class Int>
+bool SqrtContext<Int>::IsSquare(const FieldElem<Int>& a) const {
+    return a.IsZero() || Pow(a, euler_bits_) == one_;
+}
+
+template <class Int>
+std::optional<FieldElem<Int>> SqrtContext<Int>::Sqrt(const FieldElem<Int>& a) const {
+    if (a.IsZero()) {
+        return a;
+    }
+    if (method_ != Method::kTonelliShanks) {
+        FieldElem<Int> r;
+        if (method_ == Method::kThreeModFour) {
+            r = Pow(a, root_bits_);
+        } else {
+            // with b = (2a)^((p - 5) / 8), i = 2ab^2 is a square root of -1 for square a
+            FieldElem<Int> two_a = a + a;
+            FieldElem<Int> b = Pow(two_a, root_bits_);
+            r = a * b * (two_a * b * b - one_);
         }
+        if (!(r * r == a)) {
+            return std::nullopt;
+        }
+        return r;
+    }
 
-        Int b = ModExp(c, power, p);
-        r = (r * b) % p;
-        c = (b * b) % p;
-        t = (t * c) % p;
+    // r = a^((q + 1) / 2) and t = a^q keep r^2 = at, each step halves the order of t
+    FieldElem<Int> w = Pow(a, root_bits_);
+    FieldElem<Int> r = a * w;
+    FieldElem<Int> t = r * w;
+    size_t m = s_;
+    while (!(t == one_)) {
+        size_t i = 0;
+        FieldElem<Int> t2 = t;
+        while (!(t2 == one_)) {
+            t2 *= t2;
+            if (++i == m) {
+                return std::nullopt;
+            }
+        }
+        // the current c is c^(2^(s - m)) of the cached one, so b = c^(2^(m - i - 1)) is a lookup
+        r *= c_powers_[s_ - i - 1];
+        t *= c_powers_[s_ - i];
         m = i;
     }
-
     return r;
-}
\ No newline at end of file
+}
+
+// square root of a modulo an odd prime p, -1 for a non-residue; builds a SqrtContext per call
+template <class Int>
+Int TonelliShanks(Int a, Int p) {
+    PrimeField<Int> field(p);
+    SqrtContext<Int> ctx(field);
+    std::optional<FieldElem<Int>> r = ctx.Sqrt(FieldElem<Int>(a, field));
+    return r ? r->GetVal() : Int{-1};
+}
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// invariant: x = alpha^a * beta^b
+template <class GroupElem, class Int>
+struct WalkTriple {
+    GroupElem x;
+    Int a;
+    Int b;
+};
+
+// scratch space of RhoWalk::BatchStep, kept between steps to avoid reallocating
+template <class GroupElem, class Int>
+struct BatchStepBuffers {
+    std::vector<GroupElem> addends;
+    std::vector<WalkTriple<GroupElem, Int>> start;  // the lanes before the step
+    std::vector<size_t> lanes;                      // lanes to redo and the slot they used
+    std::vector<size_t> slots;
+    std::vector<GroupElem> x;
+};
+
+// a point is distinguished when dp_bits bits of its hash above the walk partition are zero,
+// so on average one point in 2^dp_bits is reported
+inline bool IsDistinguished(size_t hash, size_t partitions, int dp_bits) {
+    // a shift by the width of size_t or more is undefined, every bit has to be zero then
+    const int width = std::numeric_limits<size_t>::digits;
+    size_t mask = dp_bits <= 0 ? 0 : dp_bits >= width ? ~size_t{0} : (size_t{1} << dp_bits) - 1;
+    return ((hash / partitions) & mask) == 0;
+}
+
+// a walk that met no distinguished point in this many steps is likely stuck in a cycle
+inline int64_t MaxWalkLength(int dp_bits) {
+    return int64_t{20} << std::clamp(dp_bits, 0, 56);
+}
+
+// partition of a point and its distinguished-point test
+struct WalkPartition {
+    size_t index;
+    bool distinguished;
+};
+
+// GroupElem opts into a cheaper partition than std::hash with
+// Partition(size_t partitions, int dp_bits) returning {index, distinguished}
+template <class GroupElem, class = void>
+struct HasPartition : std::false_type {};
+
+template <class GroupElem>
+struct HasPartition<GroupElem, std::void_t<decltype(std::declval<const GroupElem&>().Partition(
+                                   size_t{}, int{}))>> : std::true_type {};
+
+// GroupElem opts into the negation map with bool Canonicalize() that replaces x by -x
+// for one element of every pair {x, -x} and returns true if it did
+template <class GroupElem, class = void>
+struct HasNegationMap : std::false_type {};
+
+template <class GroupElem>
+struct HasNegationMap<GroupElem, std::void_t<decltype(std::declval<GroupElem&>().Canonicalize())>>
+    : std::true_type {};
+
+// GroupElem declares static constexpr int kInversionsPerAdd when its operator+ inverts field
+// elements, for statistics only
+template <class GroupElem, class = void>
+struct InversionsPerAdd : std::integral_constant<int, 0> {};
+
+template <class GroupElem>
+struct InversionsPerAdd<GroupElem, std::void_t<decltype(GroupElem::kInversionsPerAdd)>>
+    : std::integral_constant<int, GroupElem::kInversionsPerAdd> {};
+
+// a base raised to many exponents below a bound, as the random starts of a walk need
+template <class GroupElem, class Int>
+class PlainFixedBase {
+public:
+    PlainFixedBase(const GroupElem& base, const Int&) : base_{base} {
+    }
+
+    GroupElem Power(const Int& n) const {
+        return base_.Power(n);
+    }
+
+private:
+    GroupElem base_;
+};
+
+// GroupElem declares FixedBase when it has a precomputed table for fixed bases, constructed
+// from the base and the exponent bound like PlainFixedBase
+template <class GroupElem, class Int, class = void>
+struct FixedBaseOf {
+    using type = PlainFixedBase<GroupElem, Int>;
+};
+
+template <class GroupElem, class Int>
+struct FixedBaseOf<GroupElem, Int, std::void_t<typename GroupElem::FixedBase>> {
+    using type = typename GroupElem::FixedBase;
+};
+
+// GroupElem declares static MultiScalarMul(points, scalars) when it sums several powers faster
+// than one Power() per term
+template <class GroupElem, class Int, class = void>
+struct HasMultiScalarMul : std::false_type {};
+
+template <class GroupElem, class Int>
+struct HasMultiScalarMul<
+    GroupElem, Int,
+    std::void_t<decltype(GroupElem::MultiScalarMul(std::declval<const std::vector<GroupElem>&>(),
+                                                   std::declval<const std::vector<Int>&>()))>>
+    : std::true_type {};
+
+// alpha^a * beta^b
+template <class GroupElem, class Int>
+GroupElem PowerSum(const GroupElem& alpha, const Int& a, const GroupElem& beta, const Int& b) {
+    if constexpr (HasMultiScalarMul<GroupElem, Int>::value) {
+        return GroupElem::MultiScalarMul({alpha, beta}, {a, b});
+    } else {
+        return alpha.Power(a) + beta.Power(b);
+    }
+}
+
+// group operations made by a walk
+struct WalkCounters {
+    uint64_t additions = 0;
+    uint64_t doublings = 0;
+};
+
+// shape of the iteration function: the partition of x picks one of adding_slots multipliers
+// M_i = alpha^c_i * beta^d_i to add or one of doubling_slots doublings
+struct WalkOptions {
+    int adding_slots;
+    int doubling_slots;
+    bool pollard;  // multipliers are beta and alpha themselves
+    // walk on classes {x, -x}, ignored unless GroupElem has HasNegationMap
+    bool negation_map = false;
+    // multipliers are powers of alpha only, so the walk is the same for every beta and x keeps
+    // the form alpha^a * beta^b for whatever beta it started from; overrides pollard
+    bool beta_independent = false;
+
+    WalkOptions WithNegationMap() const {
+        WalkOptions options = *this;
+        options.negation_map = true;
+        return options;
+    }
+
+    WalkOptions BetaIndependent() const {
+        WalkOptions options = *this;
+        options.beta_independent = true;
+        return options;
+    }
+
+    // classic Pollard walk: add beta, double, add alpha
+    static WalkOptions ThreePartition() {
+        return {2, 1, true};
+    }
+
+    // Teske's r-adding walk, r = 16..32 behaves close to a random map
+    static WalkOptions Adding(int r) {
+        return {r, 0, false};
+    }
+
+    // r-adding walk with a few doubling slots mixed in
+    static WalkOptions Mixed(int r, int doublings) {
+        return {r, doublings, false};
+    }
+};
+
+template <class GroupElem, class Int>
+class RhoWalk {
+public:
+    using Triple = WalkTriple<GroupElem, Int>;
+
+    RhoWalk(const GroupElem& alpha, const GroupElem& beta, int64_t order, WalkOptions options,
+            std::mt19937& gen)
+        : order_{order}, negation_map_{options.negation_map && HasNegationMap<GroupElem>::value} {
+        if (options.pollard && !options.beta_independent) {
+            slots_.push_back(Slot{false, beta, Int{0}, Int{1}});
+            slots_.push_back(Slot{true, GroupElem(), Int{0}, Int{0}});
+            slots_.push_back(Slot{false, alpha, Int{1}, Int{0}});
+            return;
+        }
+        std::uniform_int_distribution<int64_t> dist(0, order - 1);
+        for (int i = 0; i < options.adding_slots; ++i) {
+            Int c{dist(gen)};
+            if (options.beta_independent) {
+                slots_.push_back(Slot{false, alpha.Power(c), c, Int{0}});
+                continue;
+            }
+            Int d{dist(gen)};
+            slots_.push_back(Slot{false, PowerSum(alpha, c, beta, d), c, d});
+        }
+        for (int i = 0; i < options.doubling_slots; ++i) {
+            slots_.push_back(Slot{true, GroupElem(), Int{0}, Int{0}});
+        }
+    }
+
+    // partition of x and whether x is distinguished, from a single hash evaluation
+    WalkPartition Classify(const GroupElem& x, int dp_bits) const {
+        if constexpr (HasPartition<GroupElem>::value) {
+            auto part = x.Partition(slots_.size(), dp_bits);
+            return {part.index, part.distinguished};
+        } else {
+            size_t hash = std::hash<GroupElem>{}(x);
+            return {hash % slots_.size(), IsDistinguished(hash, slots_.size(), dp_bits)};
+        }
+    }
+
+    // Step() of every lane with one GroupElem::BatchAdd for all of them: part[i] is the
+    // partition of x[i] on entry and of the new x[i] on return. Under the negation map the lanes
+    // that land in their own slot are redone with the next slot as in Step(), sharing one more
+    // BatchAdd per attempt. Returns the group operations, doublings included
+    size_t BatchStep(std::vector<GroupElem>& x, std::vector<Int>& a, std::vector<Int>& b,
+                     std::vector<WalkPartition>& part, int dp_bits,
+                     BatchStepBuffers<GroupElem, Int>& buf) const {
+        size_t n = x.size();
+        if (negation_map_) {
+            buf.start.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                buf.start[i] = {x[i], a[i], b[i]};
+            }
+        }
+        buf.addends.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            buf.addends[i] = Addend(part[i].index, x[i], a[i], b[i]);
+        }
+        GroupElem::BatchAdd(x, buf.addends);
+        size_t operations = n;
+
+        buf.lanes.clear();
+        buf.slots.clear();
+        for (size_t i = 0; i < n; ++i) {
+            size_t slot = part[i].index;
+            Canonicalize(x[i], a[i], b[i]);
+            part[i] = Classify(x[i], dp_bits);
+            if (negation_map_ && part[i].index == slot) {
+                buf.lanes.push_back(i);
+                buf.slots.push_back(slot);
+            }
+        }
+        for (size_t attempt = 1; attempt < slots_.size() && !buf.lanes.empty(); ++attempt) {
+            size_t m = buf.lanes.size();
+            buf.x.resize(m);
+            buf.addends.resize(m);
+            for (size_t k = 0; k < m; ++k) {
+                size_t i = buf.lanes[k];
+                buf.slots[k] = (buf.slots[k] + 1) % slots_.size();
+                buf.x[k] = buf.start[i].x;
+                a[i] = buf.start[i].a;
+                b[i] = buf.start[i].b;
+                buf.addends[k] = Addend(buf.slots[k], buf.x[k], a[i], b[i]);
+            }
+            GroupElem::BatchAdd(buf.x, buf.addends);
+            operations += m;
+
+            size_t kept = 0;
+            for (size_t k = 0; k < m; ++k) {
+                size_t i = buf.lanes[k];
+                x[i] = std::move(buf.x[k]);
+                Canonicalize(x[i], a[i], b[i]);
+                part[i] = Classify(x[i], dp_bits);
+                if (part[i].index == buf.slots[k]) {
+                    buf.lanes[kept] = i;
+                    buf.slots[kept] = buf.slots[k];
+                    ++kept;
+                }
+            }
+            buf.lanes.resize(kept);
+            buf.slots.resize(kept);
+        }
+        return operations;
+    }
+
+    // number of partitions the hash of x is reduced modulo
+    size_t Partitions() const {
+        return slots_.size();
+    }
+
+    bool NegationMap() const {
+        return negation_map_;
+    }
+
+    // under the negation map replaces x by its class representative, -x = alpha^-a * beta^-b
+    void Canonicalize(GroupElem& x, Int& a, Int& b) const {
+        if constexpr (HasNegationMap<GroupElem>::value) {
+            if (negation_map_ && x.Canonicalize()) {
+                a = (order_ - a) % order_;
+                b = (order_ - b) % order_;
+            }
+        }
+    }
+
+    void Double(GroupElem& x, Int& a, Int& b) const {
+        x = x + x;
+        a = (a * Int{2}) % order_;
+        b = (b * Int{2}) % order_;
+        Canonicalize(x, a, b);
+    }
+
+    // under the negation map a step that lands in its own slot is retried with the next slot,
+    // otherwise the following step would undo it and close a fruitless 2-cycle;
+    // counters, if given, count the group operations
+    Triple Next(const Triple& t, WalkCounters* counters = nullptr) const {
+        size_t slot = Classify(t.x, 0).index;
+        Triple res = t;
+        for (size_t attempt = 0; attempt < slots_.size(); ++attempt) {
+            res = t;
+            res.x = t.x + Addend(slot, t.x, res.a, res.b);
+            if (counters) {
+                ++(slots_[slot].doubling ? counters->doublings : counters->additions);
+            }
+            Canonicalize(res.x, res.a, res.b);
+            if (!negation_map_ || Classify(res.x, 0).index != slot) {
+                break;
+            }
+            slot = (slot + 1) % slots_.size();
+        }
+        return res;
+    }
+
+    // Next() for walks that test every point for being distinguished: part is the partition
+    // of t.x on entry and of the new t.x on return, so each point is hashed once
+    void Step(Triple& t, WalkPartition& part, int dp_bits) const {
+        size_t slot = part.index;
+        Triple res = t;
+        for (size_t attempt = 0; attempt < slots_.size(); ++attempt) {
+            res = t;
+            res.x = t.x + Addend(slot, t.x, res.a, res.b);
+            Canonicalize(res.x, res.a, res.b);
+            part = Classify(res.x, dp_bits);
+            if (!negation_map_ || part.index != slot) {
+                break;
+            }
+            slot = (slot + 1) % slots_.size();
+        }
+        t = std::move(res);
+    }
+
+private:
+    struct Slot {
+        bool doubling;
+        GroupElem m;  // alpha^c * beta^d
+        Int c;
+        Int d;
+    };
+
+    const GroupElem& Addend(size_t slot_index, const GroupElem& x, Int& a, Int& b) const {
+        const Slot& slot = slots_[slot_index];
+        if (slot.doubling) {
+            a = (a * Int{2}) % order_;
+            b = (b * Int{2}) % order_;
+            return x;
+        }
+        a = (a + slot.c) % order_;
+        b = (b + slot.d) % order_;
+        return slot.m;
+    }
+
+    Int order_;
+    bool negation_map_;
+    std::vector<Slot> slots_;
+};
+
+// under the negation map x -> -(x + M_i) -> x is a fruitless 2-cycle whenever both points fall
+// into slot i; remembers the last two points of a walk to detect one and leave it
+template <class GroupElem, class Int>
+class TwoCycleGuard {
+public:
+    // call after every step, returns true if x repeated the point two steps back and was moved
+    // out of the cycle by doubling the cycle member with the smaller hash
+    bool Check(const RhoWalk<GroupElem, Int>& walk, GroupElem& x, Int& a, Int& b) {
+        if (steps_ >= 2 && x == prev2_) {
+            auto hash = std::hash<GroupElem>{};
+            if (hash(prev_.x) < hash(x)) {
+                x = prev_.x;
+                a = prev_.a;
+                b = prev_.b;
+            }
+            walk.Double(x, a, b);
+            steps_ = 0;
+            return true;
+        }
+        prev2_ = prev_.x;
+        prev_ = {x, a, b};
+        ++steps_;
+        return false;
+    }
+
+private:
+    WalkTriple<GroupElem, Int> prev_;
+    GroupElem prev2_;
+    int steps_ = 0;
+};
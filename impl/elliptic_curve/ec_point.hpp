@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cassert>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include <elliptic_curve/field.hpp>
+#include <long_arithmetic/fixed_int.hpp>
 #include <long_arithmetic/long_int.hpp>
 
 // elliptic curve y^2 = x^3 + ax + b over finite field F_p
@@ -15,7 +19,7 @@ public:
     EllipticCurve(Int a, Int b, Int p, Int q) : a_(a), b_(b), p_(p), q_(q) {
     }
 
-    Int GroupOrder();
+    Int GroupOrder() const;
     Int A() const;
     Int B() const;
     Int Prime() const;
@@ -27,55 +31,158 @@ private:
     Int q_;  // group order
 };
 
+template <class Int>
+class CurveContext;
+
+template <class Int>
+class FixedBaseComb;
+
+// point of the curve of a CurveContext, of the process-wide default context set by
+// SetEllipticCurve() unless constructed with one; operands must share the context
 template <class Int>
 class ECPoint {
 public:
-    ECPoint() {
-        neutral_ = true;
-    }
+    ECPoint();
     ECPoint(Int x, Int y);
+    ECPoint(Int x, Int y, const CurveContext<Int>& ctx);
+    // the neutral point of ctx
+    explicit ECPoint(const CurveContext<Int>& ctx);
 
     static void SetEllipticCurve(EllipticCurve<Int> ec);
 
+    const CurveContext<Int>& Context() const {
+        return *ctx_;
+    }
+
+    // operator+ works in affine coordinates, one field inversion per addition or doubling
+    static constexpr int kInversionsPerAdd = 1;
+
     ECPoint& operator+=(const ECPoint& other);
     ECPoint operator+(const ECPoint& other) const;
 
+    // points[i] += addends[i] for every i, sharing one field inversion (Montgomery's trick)
+    static void BatchAdd(std::vector<ECPoint>& points, const std::vector<ECPoint>& addends);
+
+    // sum of points[i].Power(scalars[i]) with shared doublings and one inversion: Shamir's trick
+    // over the joint sparse form for two terms, interleaved width-w NAFs (Straus) below
+    // kPippengerTerms terms and Pippenger's buckets from there on
+    static ECPoint MultiScalarMul(const std::vector<ECPoint>& points,
+                                  const std::vector<Int>& scalars);
+    static constexpr size_t kPippengerTerms = 32;
+
     bool IsNeutral() const;
     ECPoint GetInverse() const;
+    // replaces P by -P when y is in the upper half, true if it did
+    bool Canonicalize();
     Int GroupOrder() const;
+    // width-w NAF in Jacobian coordinates, w grows with the bit length of n; n <= 0 gives the
+    // neutral point
     ECPoint Power(Int n) const;
 
+    // precomputed table for bases raised to many exponents, see FixedBaseComb
+    using FixedBase = FixedBaseComb<Int>;
+
     bool operator==(const ECPoint& other) const;
 
     Int X() const;
     Int Y() const;
 
+    // full-width hash of both coordinates for hash tables, 0 for the neutral point
+    size_t Hash() const;
+
+    struct PartitionInfo {
+        size_t index;
+        bool distinguished;  // dp_bits bits above the partition are zero
+    };
+
+    // partition of a rho walk and distinguished-point test from the low limb of x alone,
+    // no temporaries; P and -P share it, as the negation map needs
+    PartitionInfo Partition(size_t partitions, int dp_bits) const;
+
 private:
-    static EllipticCurve<Int> EC;
+    friend class FixedBaseComb<Int>;
 
+    // Jacobian coordinates (X : Y : Z) of the affine point (X / Z^2, Y / Z^3),
+    // used by multi-step chains so that only the final conversion pays for an inversion
+    struct Jacobian {
+        bool neutral;
+        FieldElem<Int> X;
+        FieldElem<Int> Y;
+        FieldElem<Int> Z;
+    };
+
+    // affine P + Q with a known chord or tangent slope lambda
+    void ApplySlope(const FieldElem<Int>& lambda, const FieldElem<Int>& other_x);
+    // false when P + Q is not a chord or tangent through two affine points
+    static bool HasSlope(const ECPoint& P, const ECPoint& Q);
+
+    static Jacobian ToJacobian(const ECPoint& P);
+    ECPoint FromJacobian(const Jacobian& J) const;
+    void Double(Jacobian& J) const;
+    void AddAffine(Jacobian& J, const ECPoint& P) const;
+    void AddJacobian(Jacobian& J, const Jacobian& Q) const;
+    Jacobian NeutralJacobian() const;
+    // P, 3P, ..., (2^(w-1) - 1)P and their negatives
+    void OddMultiples(int w, std::vector<Jacobian>& odd, std::vector<Jacobian>& negated) const;
+    static int NafWidth(size_t length);
+
+    static CurveContext<Int> default_context_;
+
+    const CurveContext<Int>* ctx_;
     bool neutral_;
-    Int x_;
-    Int y_;
+    FieldElem<Int> x_;
+    FieldElem<Int> y_;
 };
 
-template <>
-struct std::hash<ECPoint<int64_t>> {
-    std::size_t operator()(const ECPoint<int64_t>& P) const {
-        auto h = std::hash<int64_t>{};
-        return h(P.X()) ^ h(P.Y() << 1);
+// curve parameters with their field and precomputed constants, so that one process can work
+// with many curves at once; points keep a pointer to their context, so it is neither copyable
+// nor movable and must outlive them
+template <class Int>
+class CurveContext {
+public:
+    CurveContext() = default;
+    explicit CurveContext(const EllipticCurve<Int>& ec, FieldRepr repr = FieldRepr::kMontgomery) {
+        Init(ec, repr);
+    }
+    CurveContext(const CurveContext&) = delete;
+    CurveContext& operator=(const CurveContext&) = delete;
+
+    void Init(const EllipticCurve<Int>& ec, FieldRepr repr = FieldRepr::kMontgomery) {
+        ec_ = ec;
+        field_.Init(ec.Prime(), repr);
+        a_ = FieldElem<Int>(ec.A(), field_);
+    }
+
+    const EllipticCurve<Int>& Curve() const {
+        return ec_;
     }
+    const PrimeField<Int>& Field() const {
+        return field_;
+    }
+    // the coefficient a as a field element
+    const FieldElem<Int>& A() const {
+        return a_;
+    }
+
+    ECPoint<Int> Point(Int x, Int y) const {
+        return ECPoint<Int>(x, y, *this);
+    }
+
+private:
+    EllipticCurve<Int> ec_;
+    PrimeField<Int> field_;
+    FieldElem<Int> a_;
 };
 
-template <>
-struct std::hash<ECPoint<LongInt>> {
-    std::size_t operator()(const ECPoint<LongInt>& P) const {
-        auto h = std::hash<int64_t>{};
-        return h(P.X().NarrowToInt()) ^ h(P.Y().NarrowToInt() << 1);
+template <class Int>
+struct std::hash<ECPoint<Int>> {
+    std::size_t operator()(const ECPoint<Int>& P) const {
+        return P.Hash();
     }
 };
 
 template <class Int>
-Int EllipticCurve<Int>::GroupOrder() {
+Int EllipticCurve<Int>::GroupOrder() const {
     return q_;
 }
 
@@ -95,19 +202,31 @@ Int EllipticCurve<Int>::Prime() const {
 }
 
 template <class Int>
-EllipticCurve<Int> ECPoint<Int>::EC;
+CurveContext<Int> ECPoint<Int>::default_context_;
 
+// also makes ec.Prime() the default field of FieldElem
 template <class Int>
 void ECPoint<Int>::SetEllipticCurve(EllipticCurve<Int> ec) {
-    EC = ec;
+    default_context_.Init(ec);
     FieldElem<Int>::SetPrime(ec.Prime());
 }
 
 template <class Int>
-ECPoint<Int>::ECPoint(Int x, Int y) {
-    x_ = FieldElem<Int>(x).GetVal();
-    y_ = FieldElem<Int>(y).GetVal();
-    neutral_ = false;
+ECPoint<Int>::ECPoint() : ECPoint(default_context_) {
+}
+
+template <class Int>
+ECPoint<Int>::ECPoint(Int x, Int y) : ECPoint(x, y, default_context_) {
+}
+
+template <class Int>
+ECPoint<Int>::ECPoint(Int x, Int y, const CurveContext<Int>& ctx)
+    : ctx_(&ctx), neutral_(false), x_(x, ctx.Field()), y_(y, ctx.Field()) {
+}
+
+template <class Int>
+ECPoint<Int>::ECPoint(const CurveContext<Int>& ctx)
+    : ctx_(&ctx), neutral_(true), x_(ctx.Field()), y_(ctx.Field()) {
 }
 
 template <class Int>
@@ -117,27 +236,79 @@ ECPoint<Int>& ECPoint<Int>::operator+=(const ECPoint& other) {
     } else if (neutral_) {
         *this = other;
         return *this;
-    } else if (x_ == other.x_ && FieldElem<Int>(y_) == FieldElem<Int>(-other.y_)) {
+    } else if (x_ == other.x_ && y_ == -other.y_) {
         this->neutral_ = true;
         return *this;
     } else {
         FieldElem<Int> lambda;
         if (*this == other) {
-            lambda = (FieldElem<Int>(3) * FieldElem<Int>(x_) * FieldElem<Int>(x_) +
-                      FieldElem<Int>(EC.A())) /
-                     (FieldElem<Int>(2) * FieldElem<Int>(y_));
+            FieldElem<Int> xx = x_ * x_;
+            lambda = (xx + xx + xx + ctx_->A()) / (y_ + y_);
         } else {
-            lambda = (FieldElem<Int>(other.y_) - FieldElem<Int>(y_)) /
-                     (FieldElem<Int>(other.x_) - FieldElem<Int>(x_));
+            lambda = (other.y_ - y_) / (other.x_ - x_);
         }
-        FieldElem<Int> X = lambda * lambda - FieldElem<Int>(x_) - FieldElem<Int>(other.x_);
-        FieldElem<Int> Y = lambda * (FieldElem<Int>(x_) - X) - FieldElem<Int>(y_);
-        ECPoint point(X.GetVal(), Y.GetVal());
-        *this = point;
+        ApplySlope(lambda, other.x_);
         return *this;
     }
 }
 
+template <class Int>
+void ECPoint<Int>::ApplySlope(const FieldElem<Int>& lambda, const FieldElem<Int>& other_x) {
+    FieldElem<Int> X = lambda * lambda - x_ - other_x;
+    y_ = lambda * (x_ - X) - y_;
+    x_ = X;
+}
+
+template <class Int>
+bool ECPoint<Int>::HasSlope(const ECPoint& P, const ECPoint& Q) {
+    if (P.neutral_ || Q.neutral_) {
+        return false;
+    }
+    if (P.x_ == Q.x_) {
+        return P.y_ == Q.y_ && !P.y_.IsZero();
+    }
+    return true;
+}
+
+template <class Int>
+void ECPoint<Int>::BatchAdd(std::vector<ECPoint>& points, const std::vector<ECPoint>& addends) {
+    size_t k = points.size();
+    if (k == 0) {
+        return;
+    }
+    const CurveContext<Int>& ctx = *points[0].ctx_;
+    const FieldElem<Int> one(Int{1}, ctx.Field());
+    std::vector<FieldElem<Int>> denominators(k, one);
+    std::vector<FieldElem<Int>> prefix(k);
+    FieldElem<Int> acc = one;
+    for (size_t i = 0; i < k; ++i) {
+        const ECPoint& P = points[i];
+        const ECPoint& Q = addends[i];
+        if (HasSlope(P, Q)) {
+            denominators[i] = (P.x_ == Q.x_) ? P.y_ + P.y_ : Q.x_ - P.x_;
+            acc *= denominators[i];
+        }
+        prefix[i] = acc;
+    }
+    FieldElem<Int> inv = acc.Inverse();
+    for (size_t i = k; i-- > 0;) {
+        ECPoint& P = points[i];
+        const ECPoint& Q = addends[i];
+        if (!HasSlope(P, Q)) {
+            P += Q;
+            continue;
+        }
+        FieldElem<Int> denominator_inv = (i > 0) ? inv * prefix[i - 1] : inv;
+        inv *= denominators[i];
+        FieldElem<Int> numerator = Q.y_ - P.y_;
+        if (P.x_ == Q.x_) {
+            FieldElem<Int> xx = P.x_ * P.x_;
+            numerator = xx + xx + xx + ctx.A();
+        }
+        P.ApplySlope(numerator * denominator_inv, Q.x_);
+    }
+}
+
 template <class Int>
 ECPoint<Int> ECPoint<Int>::operator+(const ECPoint& other) const {
     ECPoint res = *this;
@@ -153,13 +324,41 @@ bool ECPoint<Int>::IsNeutral() const {
 template <class Int>
 ECPoint<Int> ECPoint<Int>::GetInverse() const {
     ECPoint inv = *this;
-    inv.y_ = (FieldElem<Int>(0) - FieldElem<Int>(y_)).GetVal();
+    inv.y_ = -y_;
     return inv;
 }
 
+template <class Int>
+size_t ECPoint<Int>::Hash() const {
+    if (neutral_) {
+        return 0;
+    }
+    size_t h = x_.Hash();
+    return h ^ (y_.Hash() + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2));
+}
+
+template <class Int>
+typename ECPoint<Int>::PartitionInfo ECPoint<Int>::Partition(size_t partitions,
+                                                              int dp_bits) const {
+    uint64_t low = neutral_ ? 0 : x_.LowLimb();
+    uint64_t rest = low / partitions;
+    // a shift by 64 or more is undefined, every bit of rest has to be zero then
+    uint64_t mask = dp_bits <= 0 ? 0 : dp_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << dp_bits) - 1;
+    return {static_cast<size_t>(low - rest * partitions), (rest & mask) == 0};
+}
+
+template <class Int>
+bool ECPoint<Int>::Canonicalize() {
+    if (neutral_ || !y_.IsUpperHalf()) {
+        return false;
+    }
+    y_ = -y_;
+    return true;
+}
+
 template <class Int>
 Int ECPoint<Int>::GroupOrder() const {
-    return EC.GroupOrder();
+    return ctx_->Curve().GroupOrder();
 }
 
 template <class Int>
@@ -172,24 +371,396 @@ bool ECPoint<Int>::operator==(const ECPoint& other) const {
 
 template <class Int>
 Int ECPoint<Int>::X() const {
-    return x_;
+    return x_.GetVal();
 }
 
 template <class Int>
 Int ECPoint<Int>::Y() const {
-    return y_;
+    return y_.GetVal();
+}
+
+template <class Int>
+typename ECPoint<Int>::Jacobian ECPoint<Int>::ToJacobian(const ECPoint& P) {
+    return Jacobian{P.neutral_, P.x_, P.y_, FieldElem<Int>(Int{1}, P.ctx_->Field())};
+}
+
+template <class Int>
+ECPoint<Int> ECPoint<Int>::FromJacobian(const Jacobian& J) const {
+    ECPoint P(*ctx_);
+    if (J.neutral) {
+        return P;
+    }
+    FieldElem<Int> z_inv = J.Z.Inverse();
+    FieldElem<Int> z_inv2 = z_inv * z_inv;
+    P.neutral_ = false;
+    P.x_ = J.X * z_inv2;
+    P.y_ = J.Y * z_inv2 * z_inv;
+    return P;
+}
+
+// dbl: S = 4XY^2, M = 3X^2 + aZ^4, X' = M^2 - 2S, Y' = M(S - X') - 8Y^4, Z' = 2YZ
+template <class Int>
+void ECPoint<Int>::Double(Jacobian& J) const {
+    if (J.neutral) {
+        return;
+    }
+    if (J.Y.IsZero()) {
+        J.neutral = true;
+        return;
+    }
+    FieldElem<Int> XX = J.X * J.X;
+    FieldElem<Int> YY = J.Y * J.Y;
+    FieldElem<Int> ZZ = J.Z * J.Z;
+    FieldElem<Int> S = J.X * YY;
+    S += S;
+    S += S;
+    FieldElem<Int> M = XX + XX + XX + ctx_->A() * ZZ * ZZ;
+    FieldElem<Int> YYYY = YY * YY;
+    YYYY += YYYY;
+    YYYY += YYYY;
+    YYYY += YYYY;
+    J.Z *= J.Y;
+    J.Z += J.Z;
+    J.X = M * M - S - S;
+    J.Y = M * (S - J.X) - YYYY;
+}
+
+// mixed add with affine P: H = xZ^2 - X, R = yZ^3 - Y,
+// X' = R^2 - H^3 - 2XH^2, Y' = R(XH^2 - X') - YH^3, Z' = ZH
+template <class Int>
+void ECPoint<Int>::AddAffine(Jacobian& J, const ECPoint& P) const {
+    if (P.neutral_) {
+        return;
+    }
+    if (J.neutral) {
+        J = ToJacobian(P);
+        return;
+    }
+    FieldElem<Int> ZZ = J.Z * J.Z;
+    FieldElem<Int> H = P.x_ * ZZ - J.X;
+    FieldElem<Int> R = P.y_ * ZZ * J.Z - J.Y;
+    if (H.IsZero()) {
+        if (R.IsZero()) {
+            Double(J);
+        } else {
+            J.neutral = true;
+        }
+        return;
+    }
+    FieldElem<Int> HH = H * H;
+    FieldElem<Int> HHH = HH * H;
+    FieldElem<Int> V = J.X * HH;
+    J.X = R * R - HHH - V - V;
+    J.Y = R * (V - J.X) - J.Y * HHH;
+    J.Z *= H;
+}
+
+// digits of the width-w NAF of n > 0, least significant first: every nonzero digit is odd,
+// below 2^(w-1) in absolute value and followed by at least w - 1 zeros
+template <class Int>
+std::vector<int> WindowedNaf(const Int& n, int w) {
+    size_t length = BitLengthOf(n);
+    auto bits = [&n](size_t pos, int count) { return static_cast<int>(BitsOf(n, pos, count)); };
+    std::vector<int> naf(length + 1, 0);
+    int carry = 0;
+    for (size_t pos = 0; pos < length;) {
+        if (bits(pos, 1) == carry) {
+            ++pos;
+            continue;
+        }
+        int count = static_cast<int>(std::min<size_t>(w, length - pos));
+        int digit = bits(pos, count) + carry;
+        carry = (digit >> (w - 1)) & 1;
+        naf[pos] = digit - (carry << w);
+        pos += count;
+    }
+    naf[length] = carry;
+    return naf;
+}
+
+// add: U1 = X1 Z2^2, U2 = X2 Z1^2, S1 = Y1 Z2^3, S2 = Y2 Z1^3, H = U2 - U1, R = S2 - S1,
+// X' = R^2 - H^3 - 2 U1 H^2, Y' = R(U1 H^2 - X') - S1 H^3, Z' = Z1 Z2 H
+template <class Int>
+void ECPoint<Int>::AddJacobian(Jacobian& J, const Jacobian& Q) const {
+    if (Q.neutral) {
+        return;
+    }
+    if (J.neutral) {
+        J = Q;
+        return;
+    }
+    FieldElem<Int> Z1Z1 = J.Z * J.Z;
+    FieldElem<Int> Z2Z2 = Q.Z * Q.Z;
+    FieldElem<Int> U1 = J.X * Z2Z2;
+    FieldElem<Int> S1 = J.Y * Z2Z2 * Q.Z;
+    FieldElem<Int> H = Q.X * Z1Z1 - U1;
+    FieldElem<Int> R = Q.Y * Z1Z1 * J.Z - S1;
+    if (H.IsZero()) {
+        if (R.IsZero()) {
+            Double(J);
+        } else {
+            J.neutral = true;
+        }
+        return;
+    }
+    FieldElem<Int> HH = H * H;
+    FieldElem<Int> HHH = HH * H;
+    FieldElem<Int> V = U1 * HH;
+    J.X = R * R - HHH - V - V;
+    J.Y = R * (V - J.X) - S1 * HHH;
+    J.Z *= Q.Z;
+    J.Z *= H;
+}
+
+template <class Int>
+typename ECPoint<Int>::Jacobian ECPoint<Int>::NeutralJacobian() const {
+    const PrimeField<Int>& field = ctx_->Field();
+    return Jacobian{true, FieldElem<Int>(field), FieldElem<Int>(field), FieldElem<Int>(field)};
+}
+
+template <class Int>
+void ECPoint<Int>::OddMultiples(int w, std::vector<Jacobian>& odd,
+                                std::vector<Jacobian>& negated) const {
+    odd.assign(1, ToJacobian(*this));
+    Jacobian twice = odd[0];
+    Double(twice);
+    for (int i = 1; i < (1 << (w - 2)); ++i) {
+        odd.push_back(odd.back());
+        AddJacobian(odd.back(), twice);
+    }
+    negated = odd;
+    for (Jacobian& J : negated) {
+        J.Y = -J.Y;
+    }
 }
 
+// the wider the window, the fewer additions and the larger the table of odd multiples
+template <class Int>
+int ECPoint<Int>::NafWidth(size_t length) {
+    return length <= 24 ? 2 : length <= 96 ? 4 : 5;
+}
+
+// the odd multiples stay in Jacobian coordinates, so the chain keeps its single inversion
+// at the end
 template <class Int>
 ECPoint<Int> ECPoint<Int>::Power(Int n) const {
-    ECPoint Q = *this;
-    ECPoint R;
-    while (n > 0) {
-        if (n % Int{2} == Int{1}) {
-            R += Q;
+    Jacobian R = NeutralJacobian();
+    if (neutral_ || !(n > 0)) {
+        return FromJacobian(R);
+    }
+    int w = NafWidth(BitLengthOf(n));
+    std::vector<Jacobian> odd;
+    std::vector<Jacobian> negated;
+    OddMultiples(w, odd, negated);
+    std::vector<int> naf = WindowedNaf(n, w);
+    for (size_t i = naf.size(); i-- > 0;) {
+        Double(R);
+        if (naf[i] > 0) {
+            AddJacobian(R, odd[naf[i] / 2]);
+        } else if (naf[i] < 0) {
+            AddJacobian(R, negated[-naf[i] / 2]);
+        }
+    }
+    return FromJacobian(R);
+}
+
+// joint sparse form of k0, k1 >= 0 (Solinas), least significant column first: digits are in
+// {-1, 0, 1}, of any three consecutive columns at least one is zero and the number of nonzero
+// columns is minimal among signed binary representations
+template <class Int>
+std::vector<std::pair<int, int>> JointSparseForm(const Int& k0, const Int& k1) {
+    size_t length = std::max(BitLengthOf(k0), BitLengthOf(k1));
+    std::vector<std::pair<int, int>> jsf;
+    jsf.reserve(length + 1);
+    int d0 = 0;
+    int d1 = 0;
+    for (size_t j = 0; j < length || d0 != 0 || d1 != 0; ++j) {
+        int l0 = static_cast<int>((BitsOf(k0, j, 3) + d0) % 8);
+        int l1 = static_cast<int>((BitsOf(k1, j, 3) + d1) % 8);
+        int u0 = l0 % 2 == 0 ? 0 : l0 % 4 == 1 ? 1 : -1;
+        int u1 = l1 % 2 == 0 ? 0 : l1 % 4 == 1 ? 1 : -1;
+        if ((l0 == 3 || l0 == 5) && l1 % 4 == 2) {
+            u0 = -u0;
+        }
+        if ((l1 == 3 || l1 == 5) && l0 % 4 == 2) {
+            u1 = -u1;
         }
-        Q += Q;
-        n /= Int{2};
+        if (2 * d0 == 1 + u0) {
+            d0 = 1 - d0;
+        }
+        if (2 * d1 == 1 + u1) {
+            d1 = 1 - d1;
+        }
+        jsf.emplace_back(u0, u1);
+    }
+    return jsf;
+}
+
+// terms with a neutral point or a non-positive scalar are dropped, as Power() gives them the
+// neutral point
+template <class Int>
+ECPoint<Int> ECPoint<Int>::MultiScalarMul(const std::vector<ECPoint>& points,
+                                          const std::vector<Int>& scalars) {
+    std::vector<size_t> terms;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!points[i].neutral_ && scalars[i] > 0) {
+            terms.push_back(i);
+        }
+    }
+    if (terms.empty()) {
+        return ECPoint(points.empty() ? default_context_ : *points[0].ctx_);
+    }
+    if (terms.size() == 1) {
+        return points[terms[0]].Power(scalars[terms[0]]);
+    }
+    const ECPoint& first = points[terms[0]];
+    Jacobian R = first.NeutralJacobian();
+
+    if (terms.size() == 2) {
+        // the 9 signed combinations of P and Q, one addition per nonzero JSF column
+        const ECPoint& P = points[terms[0]];
+        const ECPoint& Q = points[terms[1]];
+        auto negate = [](Jacobian J) {
+            J.Y = -J.Y;
+            return J;
+        };
+        std::vector<Jacobian> table(9, R);
+        table[5] = ToJacobian(Q);
+        table[7] = ToJacobian(P);
+        table[8] = table[7];
+        first.AddJacobian(table[8], table[5]);
+        table[6] = table[7];
+        first.AddJacobian(table[6], negate(table[5]));
+        for (size_t i = 0; i < 4; ++i) {
+            table[i] = negate(table[8 - i]);
+        }
+        auto jsf = JointSparseForm(scalars[terms[0]], scalars[terms[1]]);
+        for (size_t i = jsf.size(); i-- > 0;) {
+            first.Double(R);
+            first.AddJacobian(R, table[(jsf[i].first + 1) * 3 + jsf[i].second + 1]);
+        }
+        return first.FromJacobian(R);
+    }
+
+    if (terms.size() < kPippengerTerms) {
+        std::vector<std::vector<int>> nafs(terms.size());
+        std::vector<std::vector<Jacobian>> odd(terms.size());
+        std::vector<std::vector<Jacobian>> negated(terms.size());
+        size_t top = 0;
+        for (size_t t = 0; t < terms.size(); ++t) {
+            const Int& n = scalars[terms[t]];
+            int w = NafWidth(BitLengthOf(n));
+            points[terms[t]].OddMultiples(w, odd[t], negated[t]);
+            nafs[t] = WindowedNaf(n, w);
+            top = std::max(top, nafs[t].size());
+        }
+        for (size_t i = top; i-- > 0;) {
+            first.Double(R);
+            for (size_t t = 0; t < terms.size(); ++t) {
+                int digit = i < nafs[t].size() ? nafs[t][i] : 0;
+                if (digit > 0) {
+                    first.AddJacobian(R, odd[t][digit / 2]);
+                } else if (digit < 0) {
+                    first.AddJacobian(R, negated[t][-digit / 2]);
+                }
+            }
+        }
+        return first.FromJacobian(R);
+    }
+
+    // c-bit windows from the top: every term goes into the bucket of its window value, the
+    // running sums over the buckets weight bucket j by j
+    int c = 2;
+    while (c < 16 && (size_t{1} << (c + 3)) <= terms.size()) {
+        ++c;
+    }
+    size_t length = 0;
+    for (size_t i : terms) {
+        length = std::max(length, BitLengthOf(scalars[i]));
     }
-    return R;
-}
\ No newline at end of file
+    std::vector<Jacobian> buckets(size_t{1} << c, R);
+    for (size_t pos = (length + c - 1) / c * c; pos > 0;) {
+        pos -= c;
+        for (int i = 0; i < c; ++i) {
+            first.Double(R);
+        }
+        for (Jacobian& bucket : buckets) {
+            bucket.neutral = true;
+        }
+        for (size_t i : terms) {
+            uint64_t window = BitsOf(scalars[i], pos, c);
+            if (window != 0) {
+                first.AddAffine(buckets[window], points[i]);
+            }
+        }
+        Jacobian running = first.NeutralJacobian();
+        Jacobian window_sum = first.NeutralJacobian();
+        for (size_t j = buckets.size(); j-- > 1;) {
+            first.AddJacobian(running, buckets[j]);
+            first.AddJacobian(window_sum, running);
+        }
+        first.AddJacobian(R, window_sum);
+    }
+    return first.FromJacobian(R);
+}
+
+// Lim-Lee comb for powers of a fixed base: with t teeth over the exponent bit length L and
+// d = ceil(L / t) columns, table[j] is the sum of 2^(i d) P over the set bits i of j, so P^n
+// takes d doublings and at most d mixed additions. The 2^t-point table is built once with t
+// inversions; exponents outside [0, 2^L) go through Power()
+template <class Int>
+class FixedBaseComb {
+public:
+    // exponents below bound take the table
+    FixedBaseComb(const ECPoint<Int>& base, const Int& bound)
+        : base_{base}, length_{std::max<size_t>(BitLengthOf(bound), 1)} {
+        teeth_ = std::clamp<size_t>(length_ / 8, 1, 8);
+        columns_ = (length_ + teeth_ - 1) / teeth_;
+        table_.assign(size_t{1} << teeth_, ECPoint<Int>(base.Context()));
+        using Jacobian = typename ECPoint<Int>::Jacobian;
+        Jacobian J = ECPoint<Int>::ToJacobian(base);
+        for (size_t i = 0; i < teeth_; ++i) {
+            if (i > 0) {
+                for (size_t j = 0; j < columns_; ++j) {
+                    base_.Double(J);
+                }
+            }
+            size_t half = size_t{1} << i;
+            std::vector<ECPoint<Int>> upper(table_.begin(), table_.begin() + half);
+            std::vector<ECPoint<Int>> spoke(half, base_.FromJacobian(J));
+            ECPoint<Int>::BatchAdd(upper, spoke);
+            std::copy(upper.begin(), upper.end(), table_.begin() + half);
+        }
+    }
+
+    const ECPoint<Int>& Base() const {
+        return base_;
+    }
+
+    ECPoint<Int> Power(const Int& n) const {
+        if (!(n > 0) || BitLengthOf(n) > length_) {
+            return base_.Power(n);
+        }
+        size_t length = BitLengthOf(n);
+        typename ECPoint<Int>::Jacobian R = base_.NeutralJacobian();
+        for (size_t column = columns_; column-- > 0;) {
+            base_.Double(R);
+            size_t index = 0;
+            for (size_t i = 0; i < teeth_; ++i) {
+                size_t pos = i * columns_ + column;
+                if (pos < length && BitOf(n, pos)) {
+                    index |= size_t{1} << i;
+                }
+            }
+            base_.AddAffine(R, table_[index]);
+        }
+        return base_.FromJacobian(R);
+    }
+
+private:
+    ECPoint<Int> base_;
+    size_t length_;
+    size_t teeth_;
+    size_t columns_;
+    std::vector<ECPoint<Int>> table_;
+};
@@ -1,76 +1,256 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <type_traits>
 
+#include <elliptic_curve/montgomery.hpp>
 #include <extended_euclidean/extended_euclidean.hpp>
 
+inline uint64_t LowLimbOf(int64_t v) {
+    return static_cast<uint64_t>(v);
+}
+
+template <class Int>
+uint64_t LowLimbOf(const Int& v) {
+    return v.Limb(0);
+}
+
+// i-th 64-bit limb of a non-negative integer, i below its limb count
+inline uint64_t LimbOf(int64_t v, size_t i) {
+    return i == 0 ? static_cast<uint64_t>(v) : 0;
+}
+
+template <class Int>
+uint64_t LimbOf(const Int& v, size_t i) {
+    return v.Limb(i);
+}
+
+// non-negative integer of count 64-bit limbs, least significant first; one limb for int64_t
+template <class Int>
+Int IntFromLimbs(const uint64_t* limbs, size_t count) {
+    if constexpr (std::is_same_v<Int, int64_t>) {
+        return count > 0 ? static_cast<int64_t>(limbs[0]) : 0;
+    } else {
+        return Int::FromLimbs(limbs, count);
+    }
+}
+
+// number of significant bits of a non-negative integer
+inline size_t BitLengthOf(int64_t v) {
+    return v == 0 ? 0 : 64 - __builtin_clzll(static_cast<uint64_t>(v));
+}
+
+template <class Int>
+size_t BitLengthOf(const Int& v) {
+    return v.BitLength();
+}
+
+// bit i of a non-negative integer, i below its bit length
+template <class Int>
+bool BitOf(const Int& v, size_t i) {
+    return (LimbOf(v, i / 64) >> (i % 64)) & 1;
+}
+
+// count < 64 bits of a non-negative integer from bit pos on, zeros above its bit length
+template <class Int>
+uint64_t BitsOf(const Int& v, size_t pos, int count) {
+    size_t limbs = (BitLengthOf(v) + 63) / 64;
+    size_t i = pos / 64;
+    size_t shift = pos % 64;
+    if (i >= limbs) {
+        return 0;
+    }
+    uint64_t bits = LimbOf(v, i) >> shift;
+    if (shift + count > 64 && i + 1 < limbs) {
+        bits |= LimbOf(v, i + 1) << (64 - shift);
+    }
+    return bits & ((uint64_t{1} << count) - 1);
+}
+
+inline size_t HashOf(int64_t v) {
+    return std::hash<int64_t>{}(v);
+}
+
+template <class Int>
+size_t HashOf(const Int& v) {
+    return v.Hash();
+}
+
+// kMontgomery keeps values as aR mod P when Montgomery<Int> supports Int and P is odd,
+// conversion happens only in the constructor and GetVal(); for FixedInt<N> it needs
+// P < 2^(64N - 2) and Init() throws std::invalid_argument otherwise
+enum class FieldRepr { kPlain, kMontgomery };
+
+// F_p with its precomputed reduction constants; field elements keep a pointer to their field,
+// so it is neither copyable nor movable and must outlive them
+template <class Int>
+class PrimeField {
+public:
+    PrimeField() = default;
+    explicit PrimeField(Int prime, FieldRepr repr = FieldRepr::kMontgomery);
+    PrimeField(const PrimeField&) = delete;
+    PrimeField& operator=(const PrimeField&) = delete;
+
+    void Init(Int prime, FieldRepr repr = FieldRepr::kMontgomery);
+
+    const Int& Prime() const {
+        return p_;
+    }
+    bool UsesMontgomery() const {
+        return use_montgomery_;
+    }
+    const Montgomery<Int>& Mont() const {
+        return mont_;
+    }
+
+private:
+    Int p_{};
+    bool use_montgomery_ = false;
+    Montgomery<Int> mont_;
+};
+
+template <class Int>
+PrimeField<Int>::PrimeField(Int prime, FieldRepr repr) {
+    Init(prime, repr);
+}
+
+template <class Int>
+void PrimeField<Int>::Init(Int prime, FieldRepr repr) {
+    p_ = prime;
+    use_montgomery_ = false;
+    if constexpr (Montgomery<Int>::kSupported) {
+        if (repr == FieldRepr::kMontgomery && prime % Int{2} == Int{1}) {
+            mont_.Init(prime);
+            use_montgomery_ = true;
+        }
+    }
+}
+
+// element of a PrimeField, of the process-wide default field set by SetPrime() unless
+// constructed with one; both operands of a binary operation must share the field
 template <class Int>
 class FieldElem {
 public:
     FieldElem() = default;
+    // zero of field
+    explicit FieldElem(const PrimeField<Int>& field) : field_(&field) {
+    }
     FieldElem(Int val);
+    FieldElem(Int val, const PrimeField<Int>& field);
 
-    static void SetPrime(Int prime);
+    static void SetPrime(Int prime, FieldRepr repr = FieldRepr::kMontgomery);
+
+    const PrimeField<Int>& Field() const {
+        return *field_;
+    }
 
     FieldElem& operator+=(const FieldElem& other);
     FieldElem& operator-=(const FieldElem& other);
     FieldElem& operator*=(const FieldElem& other);
     FieldElem& operator/=(const FieldElem& other);
 
+    FieldElem operator-() const;
     FieldElem operator+(const FieldElem& other) const;
     FieldElem operator-(const FieldElem& other) const;
     FieldElem operator*(const FieldElem& other) const;
     FieldElem operator/(const FieldElem& other) const;
 
     bool operator==(const FieldElem& other) const;
+    bool IsZero() const;
     Int GetVal() const;
 
+    // 1 / this through ModularInverse, zero for zero; in Montgomery form the inverse of aR is
+    // taken directly and lifted by two multiplications with R^2
+    FieldElem Inverse() const;
+
+    // true when the stored representative exceeds P / 2, exactly one of v and -v has it for v != 0
+    bool IsUpperHalf() const;
+
+    // low 64 bits and full-width hash of the stored representative, in Montgomery form a
+    // bijection of the value, so neither converts back
+    uint64_t LowLimb() const;
+    size_t Hash() const;
+
 private:
-    static Int P;
-    Int val_;
+    static PrimeField<Int> default_field_;
+
+    const PrimeField<Int>* field_ = &default_field_;
+    Int val_{};
 };
 
 template <class Int>
-Int FieldElem<Int>::P;
+PrimeField<Int> FieldElem<Int>::default_field_;
 
 template <class Int>
-FieldElem<Int>::FieldElem(Int val) {
+FieldElem<Int>::FieldElem(Int val) : FieldElem(val, default_field_) {
+}
+
+template <class Int>
+FieldElem<Int>::FieldElem(Int val, const PrimeField<Int>& field) : field_(&field) {
+    const Int& P = field.Prime();
     val_ = ((val % P) + P) % P;
+    if (field.UsesMontgomery()) {
+        val_ = field.Mont().ToMont(val_);
+    }
 }
 
 template <class Int>
-void FieldElem<Int>::SetPrime(Int prime) {
-    P = prime;
+void FieldElem<Int>::SetPrime(Int prime, FieldRepr repr) {
+    default_field_.Init(prime, repr);
 }
 
 template <class Int>
 FieldElem<Int>& FieldElem<Int>::operator+=(const FieldElem& other) {
     val_ += other.val_;
-    val_ %= P;
+    val_ %= field_->Prime();
     return *this;
 }
 
 template <class Int>
 FieldElem<Int>& FieldElem<Int>::operator-=(const FieldElem& other) {
-    val_ += (P - other.val_);
-    val_ %= P;
+    val_ += (field_->Prime() - other.val_);
+    val_ %= field_->Prime();
     return *this;
 }
 
 template <class Int>
 FieldElem<Int>& FieldElem<Int>::operator*=(const FieldElem& other) {
+    if (field_->UsesMontgomery()) {
+        val_ = field_->Mont().Mul(val_, other.val_);
+        return *this;
+    }
     val_ *= other.val_;
-    val_ %= P;
+    val_ %= field_->Prime();
     return *this;
 }
 
 template <class Int>
 FieldElem<Int>& FieldElem<Int>::operator/=(const FieldElem& other) {
-    FieldElem inv(SolveEquation<Int>(1, other.val_, P));
-    *this *= inv;
+    *this *= other.Inverse();
     return *this;
 }
 
+template <class Int>
+FieldElem<Int> FieldElem<Int>::Inverse() const {
+    FieldElem res(*field_);
+    res.val_ = ModularInverse(val_, field_->Prime());
+    if (field_->UsesMontgomery()) {
+        res.val_ = field_->Mont().ToMont(field_->Mont().ToMont(res.val_));
+    }
+    return res;
+}
+
+template <class Int>
+FieldElem<Int> FieldElem<Int>::operator-() const {
+    FieldElem res = *this;
+    if (!IsZero()) {
+        res.val_ = field_->Prime() - val_;
+    }
+    return res;
+}
+
 template <class Int>
 FieldElem<Int> FieldElem<Int>::operator+(const FieldElem& other) const {
     FieldElem res = *this;
@@ -104,7 +284,30 @@ bool FieldElem<Int>::operator==(const FieldElem& other) const {
     return val_ == other.val_;
 }
 
+template <class Int>
+bool FieldElem<Int>::IsZero() const {
+    return val_ == Int{0};
+}
+
 template <class Int>
 Int FieldElem<Int>::GetVal() const {
+    if (field_->UsesMontgomery()) {
+        return field_->Mont().FromMont(val_);
+    }
     return val_;
+}
+
+template <class Int>
+bool FieldElem<Int>::IsUpperHalf() const {
+    return field_->Prime() - val_ < val_;
+}
+
+template <class Int>
+uint64_t FieldElem<Int>::LowLimb() const {
+    return LowLimbOf(val_);
+}
+
+template <class Int>
+size_t FieldElem<Int>::Hash() const {
+    return HashOf(val_);
 }
\ No newline at end of file
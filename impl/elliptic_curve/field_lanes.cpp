@@ -0,0 +1,277 @@
+#include "field_lanes.hpp"
+
+#include <algorithm>
+
+#include <elliptic_curve/montgomery.hpp>
+#include <extended_euclidean/extended_euclidean.hpp>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define KERNEL_AVX2 __attribute__((target("avx2")))
+#define KERNEL_AVX512 __attribute__((target("avx512f,avx512dq")))
+#endif
+
+namespace {
+
+uint64_t MulScalar(uint64_t a, uint64_t b, uint64_t p, uint64_t p_inv) {
+    unsigned __int128 t = static_cast<unsigned __int128>(a) * b;
+    uint64_t m = static_cast<uint64_t>(t) * p_inv;
+    uint64_t res = static_cast<uint64_t>((t + static_cast<unsigned __int128>(m) * p) >> 64);
+    return res >= p ? res - p : res;
+}
+
+uint64_t AddScalar(uint64_t a, uint64_t b, uint64_t p) {
+    uint64_t s = a + b;
+    return s >= p ? s - p : s;
+}
+
+uint64_t SubScalar(uint64_t a, uint64_t b, uint64_t p) {
+    return a >= b ? a - b : a + p - b;
+}
+
+#if defined(__x86_64__)
+
+// 64x64-bit products from the four 32x32-bit partial products of _mm256_mul_epu32
+KERNEL_AVX2 __m256i MulLo256(__m256i a, __m256i b) {
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+KERNEL_AVX2 __m256i MulHi256(__m256i a, __m256i b, __m256i& lo) {
+    const __m256i low32 = _mm256_set1_epi64x(0xffffffff);
+    __m256i a_hi = _mm256_srli_epi64(a, 32);
+    __m256i b_hi = _mm256_srli_epi64(b, 32);
+    __m256i ll = _mm256_mul_epu32(a, b);
+    __m256i lh = _mm256_mul_epu32(a, b_hi);
+    __m256i hl = _mm256_mul_epu32(a_hi, b);
+    __m256i hh = _mm256_mul_epu32(a_hi, b_hi);
+    __m256i mid = _mm256_add_epi64(
+        _mm256_srli_epi64(ll, 32),
+        _mm256_add_epi64(_mm256_and_si256(lh, low32), _mm256_and_si256(hl, low32)));
+    lo = _mm256_or_si256(_mm256_slli_epi64(mid, 32), _mm256_and_si256(ll, low32));
+    return _mm256_add_epi64(
+        _mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)),
+        _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+}
+
+// values stay below 2^63, so the signed comparisons of AVX2 order them correctly
+KERNEL_AVX2 __m256i Reduce256(__m256i x, __m256i p) {
+    return _mm256_sub_epi64(x, _mm256_andnot_si256(_mm256_cmpgt_epi64(p, x), p));
+}
+
+// REDC: the low halves of ab and mp sum to 0 mod 2^64 and carry exactly when ab's is nonzero
+KERNEL_AVX2 __m256i MontMul256(__m256i a, __m256i b, __m256i p, __m256i p_inv) {
+    __m256i lo;
+    __m256i hi = MulHi256(a, b, lo);
+    __m256i m = MulLo256(lo, p_inv);
+    __m256i mp_lo;
+    __m256i mp_hi = MulHi256(m, p, mp_lo);
+    __m256i carry = _mm256_andnot_si256(_mm256_cmpeq_epi64(lo, _mm256_setzero_si256()),
+                                        _mm256_set1_epi64x(1));
+    return Reduce256(_mm256_add_epi64(_mm256_add_epi64(hi, mp_hi), carry), p);
+}
+
+KERNEL_AVX512 __m512i MulHi512(__m512i a, __m512i b, __m512i& lo) {
+    const __m512i low32 = _mm512_set1_epi64(0xffffffff);
+    __m512i a_hi = _mm512_srli_epi64(a, 32);
+    __m512i b_hi = _mm512_srli_epi64(b, 32);
+    __m512i ll = _mm512_mul_epu32(a, b);
+    __m512i lh = _mm512_mul_epu32(a, b_hi);
+    __m512i hl = _mm512_mul_epu32(a_hi, b);
+    __m512i hh = _mm512_mul_epu32(a_hi, b_hi);
+    __m512i mid = _mm512_add_epi64(
+        _mm512_srli_epi64(ll, 32),
+        _mm512_add_epi64(_mm512_and_si512(lh, low32), _mm512_and_si512(hl, low32)));
+    lo = _mm512_or_si512(_mm512_slli_epi64(mid, 32), _mm512_and_si512(ll, low32));
+    return _mm512_add_epi64(
+        _mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32)),
+        _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+}
+
+KERNEL_AVX512 __m512i Reduce512(__m512i x, __m512i p) {
+    return _mm512_mask_sub_epi64(x, _mm512_cmpge_epu64_mask(x, p), x, p);
+}
+
+KERNEL_AVX512 __m512i MontMul512(__m512i a, __m512i b, __m512i p, __m512i p_inv) {
+    __m512i lo;
+    __m512i hi = MulHi512(a, b, lo);
+    __m512i m = _mm512_mullo_epi64(lo, p_inv);
+    __m512i mp_lo;
+    __m512i mp_hi = MulHi512(m, p, mp_lo);
+    __m512i res = _mm512_add_epi64(hi, mp_hi);
+    res = _mm512_mask_add_epi64(res, _mm512_test_epi64_mask(lo, lo), res, _mm512_set1_epi64(1));
+    return Reduce512(res, p);
+}
+
+#endif
+
+}  // namespace
+
+struct FieldLanesKernels {
+    static void AddScalarLanes(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                               uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = AddScalar(a[i], b[i], f.p_);
+        }
+    }
+
+    static void SubScalarLanes(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                               uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = SubScalar(a[i], b[i], f.p_);
+        }
+    }
+
+    static void MulScalarLanes(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                               uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = MulScalar(a[i], b[i], f.p_, f.p_inv_);
+        }
+    }
+
+#if defined(__x86_64__)
+    KERNEL_AVX2 static void AddAvx2(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                                    uint64_t* out, size_t n) {
+        __m256i p = _mm256_set1_epi64x(static_cast<int64_t>(f.p_));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                Reduce256(_mm256_add_epi64(x, y), p));
+        }
+        AddScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+
+    KERNEL_AVX2 static void SubAvx2(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                                    uint64_t* out, size_t n) {
+        __m256i p = _mm256_set1_epi64x(static_cast<int64_t>(f.p_));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i borrow = _mm256_and_si256(_mm256_cmpgt_epi64(y, x), p);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                _mm256_add_epi64(_mm256_sub_epi64(x, y), borrow));
+        }
+        SubScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+
+    KERNEL_AVX2 static void MulAvx2(const FieldLanes& f, const uint64_t* a, const uint64_t* b,
+                                    uint64_t* out, size_t n) {
+        __m256i p = _mm256_set1_epi64x(static_cast<int64_t>(f.p_));
+        __m256i p_inv = _mm256_set1_epi64x(static_cast<int64_t>(f.p_inv_));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), MontMul256(x, y, p, p_inv));
+        }
+        MulScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+
+    KERNEL_AVX512 static void AddAvx512(const FieldLanes& f, const uint64_t* a,
+                                        const uint64_t* b, uint64_t* out, size_t n) {
+        __m512i p = _mm512_set1_epi64(static_cast<int64_t>(f.p_));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(out + i, Reduce512(_mm512_add_epi64(x, y), p));
+        }
+        AddScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+
+    KERNEL_AVX512 static void SubAvx512(const FieldLanes& f, const uint64_t* a,
+                                        const uint64_t* b, uint64_t* out, size_t n) {
+        __m512i p = _mm512_set1_epi64(static_cast<int64_t>(f.p_));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            __m512i d = _mm512_sub_epi64(x, y);
+            _mm512_storeu_si512(out + i,
+                                _mm512_mask_add_epi64(d, _mm512_cmplt_epu64_mask(x, y), d, p));
+        }
+        SubScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+
+    KERNEL_AVX512 static void MulAvx512(const FieldLanes& f, const uint64_t* a,
+                                        const uint64_t* b, uint64_t* out, size_t n) {
+        __m512i p = _mm512_set1_epi64(static_cast<int64_t>(f.p_));
+        __m512i p_inv = _mm512_set1_epi64(static_cast<int64_t>(f.p_inv_));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i x = _mm512_loadu_si512(a + i);
+            __m512i y = _mm512_loadu_si512(b + i);
+            _mm512_storeu_si512(out + i, MontMul512(x, y, p, p_inv));
+        }
+        MulScalarLanes(f, a + i, b + i, out + i, n - i);
+    }
+#endif
+};
+
+SimdLevel DetectSimdLevel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return SimdLevel::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::kAvx2;
+    }
+#endif
+    return SimdLevel::kScalar;
+}
+
+FieldLanes::FieldLanes(int64_t p, SimdLevel level)
+    : p_{static_cast<uint64_t>(p)},
+      p_inv_{MontgomeryNegInverse(p_)},
+      level_{std::min(level, DetectSimdLevel())} {
+    unsigned __int128 r = (static_cast<unsigned __int128>(1) << 64) % p_;
+    r2_ = static_cast<uint64_t>((r * r) % p_);
+    add_ = &FieldLanesKernels::AddScalarLanes;
+    sub_ = &FieldLanesKernels::SubScalarLanes;
+    mul_ = &FieldLanesKernels::MulScalarLanes;
+#if defined(__x86_64__)
+    if (level_ == SimdLevel::kAvx2) {
+        add_ = &FieldLanesKernels::AddAvx2;
+        sub_ = &FieldLanesKernels::SubAvx2;
+        mul_ = &FieldLanesKernels::MulAvx2;
+    } else if (level_ == SimdLevel::kAvx512) {
+        add_ = &FieldLanesKernels::AddAvx512;
+        sub_ = &FieldLanesKernels::SubAvx512;
+        mul_ = &FieldLanesKernels::MulAvx512;
+    }
+#endif
+}
+
+void FieldLanes::Add(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const {
+    add_(*this, a, b, out, n);
+}
+
+void FieldLanes::Sub(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const {
+    sub_(*this, a, b, out, n);
+}
+
+void FieldLanes::Mul(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const {
+    mul_(*this, a, b, out, n);
+}
+
+uint64_t FieldLanes::ToMont(uint64_t a) const {
+    return MulScalar(a % p_, r2_, p_, p_inv_);
+}
+
+uint64_t FieldLanes::FromMont(uint64_t a) const {
+    return MulScalar(a, 1, p_, p_inv_);
+}
+
+uint64_t FieldLanes::MulOne(uint64_t a, uint64_t b) const {
+    return MulScalar(a, b, p_, p_inv_);
+}
+
+uint64_t FieldLanes::Inverse(uint64_t a) const {
+    int64_t inv = ModularInverse(static_cast<int64_t>(a), static_cast<int64_t>(p_));
+    return ToMont(ToMont(static_cast<uint64_t>(inv)));
+}
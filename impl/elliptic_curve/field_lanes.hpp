@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// instruction set of the FieldLanes kernels
+enum class SimdLevel { kScalar, kAvx2, kAvx512 };
+
+// the widest level this CPU runs
+SimdLevel DetectSimdLevel();
+
+// Montgomery arithmetic modulo an odd prime p < 2^62 on arrays of independent lanes, in the
+// representation of Montgomery<int64_t> (aR mod p, R = 2^64) so that lanes and FieldElem<int64_t>
+// exchange values without conversion; out may alias an input. AVX2 runs 4 lanes per instruction
+// and AVX-512 8, both build the 64x64-bit products from 32-bit multiplies
+class FieldLanes {
+public:
+    // a level above DetectSimdLevel() falls back to it
+    explicit FieldLanes(int64_t p, SimdLevel level = DetectSimdLevel());
+
+    SimdLevel Level() const {
+        return level_;
+    }
+
+    uint64_t Prime() const {
+        return p_;
+    }
+
+    void Add(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const;
+    void Sub(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const;
+    void Mul(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) const;
+
+    // single values in Montgomery form
+    uint64_t ToMont(uint64_t a) const;
+    uint64_t FromMont(uint64_t a) const;
+    uint64_t MulOne(uint64_t a, uint64_t b) const;
+    // a^-1 for a != 0, both in Montgomery form
+    uint64_t Inverse(uint64_t a) const;
+
+private:
+    using Kernel = void (*)(const FieldLanes&, const uint64_t*, const uint64_t*, uint64_t*,
+                            size_t);
+
+    uint64_t p_;
+    uint64_t p_inv_;  // -p^-1 mod 2^64
+    uint64_t r2_;     // R^2 mod p
+    SimdLevel level_;
+    Kernel add_;
+    Kernel sub_;
+    Kernel mul_;
+
+    friend struct FieldLanesKernels;
+};
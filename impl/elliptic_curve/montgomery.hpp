@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <long_arithmetic/fixed_int.hpp>
+
+// Montgomery arithmetic modulo an odd prime p with R = 2^(64 * limbs),
+// values in Montgomery form are aR mod p and multiplication is a REDC instead of a division
+template <class Int>
+class Montgomery {
+public:
+    static constexpr bool kSupported = false;
+
+    void Init(const Int&) {
+    }
+    Int ToMont(const Int& a) const {
+        return a;
+    }
+    Int FromMont(const Int& a) const {
+        return a;
+    }
+    Int Mul(const Int& a, const Int& b) const {
+        return a * b;
+    }
+};
+
+// -p^-1 mod 2^64 for odd p by Newton iteration, each step doubles the number of correct bits
+inline uint64_t MontgomeryNegInverse(uint64_t p) {
+    uint64_t inv = p;
+    for (int i = 0; i < 5; ++i) {
+        inv *= 2 - p * inv;
+    }
+    return -inv;
+}
+
+// single limb, requires p < 2^63
+template <>
+class Montgomery<int64_t> {
+public:
+    static constexpr bool kSupported = true;
+
+    void Init(int64_t p) {
+        p_ = static_cast<uint64_t>(p);
+        p_inv_ = MontgomeryNegInverse(p_);
+        unsigned __int128 r = (static_cast<unsigned __int128>(1) << 64) % p_;
+        r2_ = static_cast<uint64_t>((r * r) % p_);
+    }
+
+    int64_t ToMont(int64_t a) const {
+        return Mul(a, static_cast<int64_t>(r2_));
+    }
+
+    int64_t FromMont(int64_t a) const {
+        return static_cast<int64_t>(Redc(static_cast<uint64_t>(a)));
+    }
+
+    int64_t Mul(int64_t a, int64_t b) const {
+        unsigned __int128 t = static_cast<unsigned __int128>(a) * static_cast<uint64_t>(b);
+        return static_cast<int64_t>(Redc(t));
+    }
+
+private:
+    uint64_t Redc(unsigned __int128 t) const {
+        uint64_t m = static_cast<uint64_t>(t) * p_inv_;
+        uint64_t res = static_cast<uint64_t>((t + static_cast<unsigned __int128>(m) * p_) >> 64);
+        return res >= p_ ? res - p_ : res;
+    }
+
+    uint64_t p_ = 0;
+    uint64_t p_inv_ = 0;
+    uint64_t r2_ = 0;
+};
+
+// coarsely integrated operand scanning (CIOS) over the k low limbs that p needs,
+// R = 2^(64k) and p < 2^(64k - 2); a single-limb p takes the same path as int64_t.
+// Init() throws std::invalid_argument for p >= 2^(64N - 2), the carries would overflow
+template <size_t N>
+class Montgomery<FixedInt<N>> {
+public:
+    static constexpr bool kSupported = true;
+
+    void Init(const FixedInt<N>& p) {
+        if ((p.Limb(N - 1) >> 62) != 0) {
+            throw std::invalid_argument("Montgomery<FixedInt<N>> needs p < 2^(64N - 2)");
+        }
+        p_ = p;
+        p_inv_ = MontgomeryNegInverse(p.Limb(0));
+        limbs_ = N;
+        while (limbs_ > 1 && p.Limb(limbs_ - 1) == 0 && (p.Limb(limbs_ - 2) >> 62) == 0) {
+            --limbs_;
+        }
+        r2_ = 1;
+        for (size_t i = 0; i < 2 * 64 * limbs_; ++i) {
+            r2_ += r2_;
+            if (!(r2_ < p_)) {
+                r2_ -= p_;
+            }
+        }
+    }
+
+    FixedInt<N> ToMont(const FixedInt<N>& a) const {
+        return Mul(a, r2_);
+    }
+
+    FixedInt<N> FromMont(const FixedInt<N>& a) const {
+        return Mul(a, FixedInt<N>(1));
+    }
+
+    FixedInt<N> Mul(const FixedInt<N>& a, const FixedInt<N>& b) const {
+        if (limbs_ == 1) {
+            return FixedInt<N>(static_cast<int64_t>(MulSingleLimb(a.Limb(0), b.Limb(0))));
+        }
+        uint64_t t[N + 2] = {};
+        for (size_t i = 0; i < limbs_; ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < limbs_; ++j) {
+                unsigned __int128 cur =
+                    static_cast<unsigned __int128>(a.Limb(j)) * b.Limb(i) + t[j] + carry;
+                t[j] = static_cast<uint64_t>(cur);
+                carry = static_cast<uint64_t>(cur >> 64);
+            }
+            unsigned __int128 top = static_cast<unsigned __int128>(t[limbs_]) + carry;
+            t[limbs_] = static_cast<uint64_t>(top);
+            t[limbs_ + 1] = static_cast<uint64_t>(top >> 64);
+
+            uint64_t m = t[0] * p_inv_;
+            unsigned __int128 cur = static_cast<unsigned __int128>(m) * p_.Limb(0) + t[0];
+            carry = static_cast<uint64_t>(cur >> 64);
+            for (size_t j = 1; j < limbs_; ++j) {
+                cur = static_cast<unsigned __int128>(m) * p_.Limb(j) + t[j] + carry;
+                t[j - 1] = static_cast<uint64_t>(cur);
+                carry = static_cast<uint64_t>(cur >> 64);
+            }
+            top = static_cast<unsigned __int128>(t[limbs_]) + carry;
+            t[limbs_ - 1] = static_cast<uint64_t>(top);
+            t[limbs_] = t[limbs_ + 1] + static_cast<uint64_t>(top >> 64);
+        }
+        FixedInt<N> res;
+        for (size_t i = 0; i < limbs_; ++i) {
+            res.SetLimb(i, t[i]);
+        }
+        if (!(res < p_)) {
+            res -= p_;
+        }
+        return res;
+    }
+
+private:
+    uint64_t MulSingleLimb(uint64_t a, uint64_t b) const {
+        unsigned __int128 t = static_cast<unsigned __int128>(a) * b;
+        uint64_t m = static_cast<uint64_t>(t) * p_inv_;
+        uint64_t p = p_.Limb(0);
+        uint64_t res = static_cast<uint64_t>((t + static_cast<unsigned __int128>(m) * p) >> 64);
+        return res >= p ? res - p : res;
+    }
+
+    FixedInt<N> p_;
+    uint64_t p_inv_ = 0;
+    size_t limbs_ = N;
+    FixedInt<N> r2_;
+};
@@ -0,0 +1,107 @@
+#include "point_lanes.hpp"
+
+#include <algorithm>
+#include <utility>
+
+PointLanes::PointLanes(const CurveContext<int64_t>& ctx, SimdLevel level)
+    : ctx_{&ctx}, field_{ctx.Field().Prime(), level}, one_{field_.ToMont(1)} {
+}
+
+void PointLanes::Assign(const std::vector<ECPoint<int64_t>>& points) {
+    x_.resize(points.size());
+    y_.resize(points.size());
+    neutral_.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        Set(i, points[i]);
+    }
+}
+
+void PointLanes::Set(size_t i, const ECPoint<int64_t>& P) {
+    neutral_[i] = P.IsNeutral();
+    x_[i] = P.IsNeutral() ? 0 : field_.ToMont(static_cast<uint64_t>(P.X()));
+    y_[i] = P.IsNeutral() ? 0 : field_.ToMont(static_cast<uint64_t>(P.Y()));
+}
+
+ECPoint<int64_t> PointLanes::Get(size_t i) const {
+    if (neutral_[i]) {
+        return ECPoint<int64_t>(*ctx_);
+    }
+    return ctx_->Point(static_cast<int64_t>(field_.FromMont(x_[i])),
+                       static_cast<int64_t>(field_.FromMont(y_[i])));
+}
+
+std::vector<ECPoint<int64_t>> PointLanes::Points() const {
+    std::vector<ECPoint<int64_t>> points;
+    points.reserve(Size());
+    for (size_t i = 0; i < Size(); ++i) {
+        points.push_back(Get(i));
+    }
+    return points;
+}
+
+void PointLanes::Add(const PointLanes& addends) {
+    size_t n = Size();
+    if (n == 0) {
+        return;
+    }
+    dx_.resize(n);
+    dy_.resize(n);
+    prefix_.resize(n);
+    lambda_.resize(n);
+    field_.Sub(addends.x_.data(), x_.data(), dx_.data(), n);
+    field_.Sub(addends.y_.data(), y_.data(), dy_.data(), n);
+
+    // lanes without a chord are added as ECPoints and leave a 1 in the product chains
+    std::vector<std::pair<size_t, ECPoint<int64_t>>> exceptional;
+    for (size_t i = 0; i < n; ++i) {
+        if (neutral_[i] || addends.neutral_[i] || dx_[i] == 0) {
+            exceptional.emplace_back(i, Get(i) + addends.Get(i));
+            dx_[i] = one_;
+        }
+    }
+
+    // chain c multiplies the dx of lanes c, c + kStride, ..., so one Mul advances all chains
+    size_t chains = std::min(kStride, n);
+    std::copy(dx_.begin(), dx_.begin() + chains, prefix_.begin());
+    for (size_t i = kStride; i < n; i += kStride) {
+        field_.Mul(prefix_.data() + i - kStride, dx_.data() + i, prefix_.data() + i,
+                   std::min(kStride, n - i));
+    }
+
+    // inverses of the chain products from a single inversion
+    uint64_t total[kStride];
+    uint64_t acc[kStride];
+    uint64_t inv[kStride];
+    for (size_t c = 0; c < chains; ++c) {
+        total[c] = prefix_[c + (n - 1 - c) / kStride * kStride];
+        acc[c] = c > 0 ? field_.MulOne(acc[c - 1], total[c]) : total[c];
+    }
+    uint64_t acc_inv = field_.Inverse(acc[chains - 1]);
+    for (size_t c = chains; c-- > 1;) {
+        inv[c] = field_.MulOne(acc_inv, acc[c - 1]);
+        acc_inv = field_.MulOne(acc_inv, total[c]);
+    }
+    inv[0] = acc_inv;
+
+    // walk the chains back, lambda_ first holds dx^-1
+    for (size_t i = (n - 1) / kStride * kStride; i > 0; i -= kStride) {
+        size_t m = std::min(kStride, n - i);
+        field_.Mul(inv, prefix_.data() + i - kStride, lambda_.data() + i, m);
+        field_.Mul(inv, dx_.data() + i, inv, m);
+    }
+    std::copy(inv, inv + chains, lambda_.begin());
+
+    // lambda = dy / dx, x3 = lambda^2 - x1 - x2, y3 = lambda (x1 - x3) - y1
+    field_.Mul(dy_.data(), lambda_.data(), lambda_.data(), n);
+    field_.Mul(lambda_.data(), lambda_.data(), dx_.data(), n);
+    field_.Sub(dx_.data(), x_.data(), dx_.data(), n);
+    field_.Sub(dx_.data(), addends.x_.data(), dx_.data(), n);
+    field_.Sub(x_.data(), dx_.data(), prefix_.data(), n);
+    field_.Mul(lambda_.data(), prefix_.data(), prefix_.data(), n);
+    field_.Sub(prefix_.data(), y_.data(), y_.data(), n);
+    x_.swap(dx_);
+
+    for (const auto& [i, P] : exceptional) {
+        Set(i, P);
+    }
+}
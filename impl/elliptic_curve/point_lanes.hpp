@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <elliptic_curve/ec_point.hpp>
+#include <elliptic_curve/field_lanes.hpp>
+
+// affine points of a CurveContext<int64_t> as structure-of-arrays lanes for FieldLanes,
+// coordinates in Montgomery form; the context must outlive the lanes and its prime be below 2^62
+class PointLanes {
+public:
+    // chains of the interleaved Montgomery trick in Add, one AVX-512 register of lanes
+    static constexpr size_t kStride = 8;
+
+    explicit PointLanes(const CurveContext<int64_t>& ctx, SimdLevel level = DetectSimdLevel());
+
+    const FieldLanes& Field() const {
+        return field_;
+    }
+    size_t Size() const {
+        return x_.size();
+    }
+
+    void Assign(const std::vector<ECPoint<int64_t>>& points);
+    ECPoint<int64_t> Get(size_t i) const;
+    std::vector<ECPoint<int64_t>> Points() const;
+
+    // lane i += addends lane i for every i, the same result as ECPoint::BatchAdd;
+    // kStride inversions merged into one, neutral, equal and opposite lanes run through ECPoint
+    void Add(const PointLanes& addends);
+
+private:
+    void Set(size_t i, const ECPoint<int64_t>& P);
+
+    const CurveContext<int64_t>* ctx_;
+    FieldLanes field_;
+    uint64_t one_;  // R mod p
+    std::vector<uint64_t> x_;
+    std::vector<uint64_t> y_;
+    std::vector<uint8_t> neutral_;
+
+    // scratch of Add
+    std::vector<uint64_t> dx_;
+    std::vector<uint64_t> dy_;
+    std::vector<uint64_t> prefix_;
+    std::vector<uint64_t> lambda_;
+};
@@ -2,8 +2,16 @@
 
 #include <elliptic_curve/ec_point.hpp>
 #include <elliptic_curve/field.hpp>
+#include <elliptic_curve/field_lanes.hpp>
+#include <elliptic_curve/point_lanes.hpp>
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/gmp_allocation_counter.hpp>
 #include <long_arithmetic/long_int.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
 template <class Int>
@@ -46,6 +54,79 @@ TEST(FiniteField, BigPrime) {
     }
 }
 
+TEST(FiniteField, BigPrimeFixedInt) {
+    FixedInt<2> a = 15222514519776677;
+    FixedInt<2> b = 198915293914922;
+    std::vector<FixedInt<2>> primes{1099511627791, 281474987479363, 72057594037928017};
+    for (auto p : primes) {
+        FieldElem<FixedInt<2>>::SetPrime(p);
+        FieldElem A(a);
+        FieldElem B(b);
+        EXPECT_EQ(A + B, FieldElem(a + b));
+        EXPECT_EQ(A * B, FieldElem(a * b));
+        EXPECT_EQ(A - B, FieldElem(a - b));
+        EXPECT_EQ(A / B, FieldElem(a * SolveEquation<FixedInt<2>>(1, b, p)));
+    }
+}
+
+TEST(FiniteField, MontgomeryMatchesPlain) {
+    LongInt a = 15222514519776677;
+    LongInt b = 198915293914922;
+    std::vector<int64_t> primes{1099511627791, 281474976710677, 72057594037928017};
+    for (auto p : primes) {
+        FieldElem<LongInt>::SetPrime(p);
+        LongInt prod = (FieldElem<LongInt>(a) * FieldElem<LongInt>(b)).GetVal();
+        LongInt quot = (FieldElem<LongInt>(a) / FieldElem<LongInt>(b)).GetVal();
+
+        FieldElem<int64_t>::SetPrime(p, FieldRepr::kMontgomery);
+        FieldElem<int64_t> A(a.NarrowToInt());
+        FieldElem<int64_t> B(b.NarrowToInt());
+        EXPECT_EQ((A * B).GetVal(), prod.NarrowToInt());
+        EXPECT_EQ((A / B).GetVal(), quot.NarrowToInt());
+        EXPECT_EQ((A + B).GetVal(), (a + b).NarrowToInt() % p);
+
+        for (auto repr : {FieldRepr::kPlain, FieldRepr::kMontgomery}) {
+            FieldElem<FixedInt<2>>::SetPrime(p, repr);
+            FieldElem<FixedInt<2>> C(a.NarrowToInt());
+            FieldElem<FixedInt<2>> D(b.NarrowToInt());
+            EXPECT_EQ((C * D).GetVal(), FixedInt<2>(prod.NarrowToInt()));
+            EXPECT_EQ((C / D).GetVal(), FixedInt<2>(quot.NarrowToInt()));
+        }
+    }
+}
+
+TEST(FiniteField, MontgomeryMultiLimb) {
+    FixedInt<4> p("170141183460469231731687303715884105727");  // 2^127 - 1
+    FixedInt<4> a("98765432109876543210987654321098765");
+    FixedInt<4> b("12345678901234567890123456789012345");
+    FieldElem<FixedInt<4>>::SetPrime(p, FieldRepr::kPlain);
+    FixedInt<4> prod = (FieldElem<FixedInt<4>>(a) * FieldElem<FixedInt<4>>(b)).GetVal();
+    FieldElem<FixedInt<4>>::SetPrime(p, FieldRepr::kMontgomery);
+    FieldElem<FixedInt<4>> A(a);
+    FieldElem<FixedInt<4>> B(b);
+    EXPECT_EQ((A * B).GetVal(), prod);
+    EXPECT_EQ((A * B / B).GetVal(), a);
+}
+
+TEST(FiniteField, MontgomeryBound) {
+    // the largest primes on either side of 2^126, the bound for two limbs
+    FixedInt<2> below("85070591730234615865843651857942052727");  // 2^126 - 137
+    FixedInt<2> above("85070591730234615865843651857942052871");  // 2^126 + 7
+    FixedInt<2> a("78765432109876543210987654321098765432");
+    FixedInt<2> b("12345678901234567890123456789012345678");
+    PrimeField<FixedInt<2>> field(below);
+    ASSERT_TRUE(field.UsesMontgomery());
+    FieldElem<FixedInt<2>> A(a, field);
+    FieldElem<FixedInt<2>> B(b, field);
+    EXPECT_EQ((A * B).GetVal(), FixedInt<2>("54387529550236773473023251671246477006"));
+    EXPECT_EQ((A * B / B).GetVal(), a);
+    FieldElem<FixedInt<2>> M(below - FixedInt<2>(1), field);
+    EXPECT_EQ((M * M).GetVal(), FixedInt<2>(1));
+
+    EXPECT_THROW(PrimeField<FixedInt<2>>{above}, std::invalid_argument);
+    EXPECT_FALSE(PrimeField<FixedInt<2>>(above, FieldRepr::kPlain).UsesMontgomery());
+}
+
 TEST(EllipticCurvePoint, SimpleOne) {
     EllipticCurve<int64_t> ec(7, 13, 97, 112);
     ECPoint<int64_t>::SetEllipticCurve(ec);
@@ -64,6 +145,7 @@ TEST(EllipticCurvePoint, SimpleOne) {
     EXPECT_EQ(O + O, O);
     EXPECT_EQ(P_I, P.GetInverse());
     EXPECT_EQ(P + P_I, O);
+    EXPECT_EQ(std::hash<ECPoint<int64_t>>{}(P + P_I), std::hash<ECPoint<int64_t>>{}(O));
     EXPECT_EQ(P + O, P);
     EXPECT_EQ(O + P, P);
 }
@@ -84,6 +166,22 @@ TEST(EllipticCurvePoint, SimpleTwo) {
     EXPECT_EQ(R + R_I, O);
 }
 
+TEST(EllipticCurvePoint, CurveContext) {
+    CurveContext<int64_t> first(EllipticCurve<int64_t>(7, 13, 97, 112));
+    CurveContext<int64_t> second(EllipticCurve<int64_t>(345, 717, 1297, 1246));
+    ECPoint<int64_t> P = first.Point(13, 19);
+    ECPoint<int64_t> S = second.Point(139, 53);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(P + first.Point(92, 12), first.Point(17, 1));
+        EXPECT_EQ(S + second.Point(418, 15), second.Point(747, 67));
+        EXPECT_EQ((P + P.GetInverse()).Context().Curve().Prime(), 97);
+        EXPECT_EQ(S.Power(1246), ECPoint<int64_t>(second));
+        EXPECT_EQ(P.Power(3), P + P + P);
+        // the default context follows SetEllipticCurve and leaves explicit contexts alone
+        ECPoint<int64_t>::SetEllipticCurve(EllipticCurve<int64_t>(43, 71, 149, 139));
+    }
+}
+
 TEST(ECPointFastPower, Simple) {
     EllipticCurve<int64_t> ec(7, 13, 97, 112);
     ECPoint<int64_t>::SetEllipticCurve(ec);
@@ -93,4 +191,306 @@ TEST(ECPointFastPower, Simple) {
         EXPECT_EQ(P.Power(n), slow_power<int64_t>(P, n));
     }
     EXPECT_EQ(P.Power(112), ECPoint<int64_t>());
-}
\ No newline at end of file
+}
+
+TEST(ECPointFastPower, LongChains) {
+    EllipticCurve<LongInt> ec(345, 717, 1297, 1246);
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(139, 53);
+    ECPoint<LongInt> R;
+    for (int64_t n = 0; n <= 2500; ++n) {
+        ASSERT_EQ(P.Power(n), R);
+        R += P;
+    }
+
+    EllipticCurve<FixedInt<2>> ec_fixed(345, 717, 1297, 1246);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec_fixed);
+    ECPoint<FixedInt<2>> Q(418, 15);
+    EXPECT_EQ(Q.Power(1246), ECPoint<FixedInt<2>>());
+    EXPECT_EQ(Q.Power(623) + Q.Power(700), Q.Power(77));
+}
+
+TEST(ECPointFastPower, WindowedNaf) {
+    for (const char* str :
+         {"1", "7", "18446744073709551615", "1234567890123456789012345678901234567"}) {
+        LongInt n(str);
+        for (int w = 2; w <= 6; ++w) {
+            std::vector<int> naf = WindowedNaf(n, w);
+            LongInt sum = 0;
+            for (size_t i = naf.size(); i-- > 0;) {
+                sum = sum * LongInt(2) + LongInt(naf[i]);
+                if (naf[i] != 0) {
+                    EXPECT_EQ(std::abs(naf[i]) % 2, 1);
+                    EXPECT_LT(std::abs(naf[i]), 1 << (w - 1));
+                    for (size_t j = i + 1; j < std::min(naf.size(), i + w); ++j) {
+                        EXPECT_EQ(naf[j], 0);
+                    }
+                }
+            }
+            EXPECT_EQ(sum, n);
+        }
+    }
+}
+
+TEST(ECPointFastPower, WideExponents) {
+    EllipticCurve<LongInt> ec(345, 717, 1297, 1246);
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(139, 53);
+    std::mt19937_64 gen(11);
+    LongInt n = 1;
+    // every window width and exponents across limb boundaries
+    for (int i = 0; i < 40; ++i) {
+        n = n * LongInt(static_cast<int64_t>(gen() % 1000 + 7)) + LongInt(i);
+        EXPECT_EQ(P.Power(n), P.Power(n % LongInt(1246)));
+    }
+
+    EllipticCurve<FixedInt<2>> ec_fixed(345, 717, 1297, 1246);
+    ECPoint<FixedInt<2>>::SetEllipticCurve(ec_fixed);
+    ECPoint<FixedInt<2>> Q(418, 15);
+    FixedInt<2> m("85070591730234615865843651857942052863");  // 2^126 - 1
+    EXPECT_EQ(Q.Power(m), Q.Power(m % FixedInt<2>(1246)));
+    EXPECT_EQ(Q.Power(FixedInt<2>(-5)), ECPoint<FixedInt<2>>());
+}
+
+TEST(ECPointFastPower, FixedBaseComb) {
+    EllipticCurve<LongInt> ec(345, 717, 1297, 1246);
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(139, 53);
+    ECPoint<LongInt>::FixedBase comb(P, LongInt(1246));
+    EXPECT_EQ(comb.Base(), P);
+    for (int64_t n = -3; n <= 3000; ++n) {
+        ASSERT_EQ(comb.Power(n), P.Power(n));
+    }
+
+    // eight teeth
+    LongInt bound("1267650600228229401496703205376");  // 2^100
+    FixedBaseComb<LongInt> wide(P, bound);
+    std::mt19937_64 gen(5);
+    for (int i = 0; i < 100; ++i) {
+        LongInt n = LongInt(static_cast<int64_t>(gen() >> 28)) * LongInt(int64_t{1} << 40) +
+                    LongInt(static_cast<int64_t>(gen() >> 1));
+        ASSERT_EQ(wide.Power(n), P.Power(n));
+    }
+    EXPECT_EQ(wide.Power(bound * bound), P.Power(bound * bound));
+
+    EllipticCurve<int64_t> ec_small(345, 717, 1297, 1246);
+    ECPoint<int64_t>::SetEllipticCurve(ec_small);
+    ECPoint<int64_t> Q(418, 15);
+    FixedBaseComb<int64_t> small(Q, 1246);
+    for (int64_t n = 0; n <= 1246; ++n) {
+        ASSERT_EQ(small.Power(n), Q.Power(n));
+    }
+}
+
+TEST(ECPointMultiScalarMul, JointSparseForm) {
+    std::mt19937_64 gen(13);
+    for (int i = 0; i < 200; ++i) {
+        LongInt k0 = LongInt(static_cast<int64_t>(gen() >> 1)) * LongInt(static_cast<int64_t>(i));
+        LongInt k1 = LongInt(static_cast<int64_t>(gen() >> (i % 60 + 1)));
+        auto jsf = JointSparseForm(k0, k1);
+        LongInt s0 = 0;
+        LongInt s1 = 0;
+        for (size_t j = jsf.size(); j-- > 0;) {
+            s0 = s0 * LongInt(2) + LongInt(jsf[j].first);
+            s1 = s1 * LongInt(2) + LongInt(jsf[j].second);
+            if (j + 2 < jsf.size()) {
+                bool zero_column = false;
+                for (size_t c = j; c <= j + 2; ++c) {
+                    zero_column |= jsf[c].first == 0 && jsf[c].second == 0;
+                }
+                EXPECT_TRUE(zero_column);
+            }
+        }
+        EXPECT_EQ(s0, k0);
+        EXPECT_EQ(s1, k1);
+    }
+}
+
+TEST(ECPointMultiScalarMul, MatchesPowers) {
+    EllipticCurve<LongInt> ec(345, 717, 1297, 1246);
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(139, 53);
+    std::mt19937_64 gen(17);
+    // two terms, Straus and Pippenger, including repeated, opposite and neutral points
+    for (size_t k : {0, 1, 2, 3, 7, 31, 32, 100}) {
+        for (int round = 0; round < 5; ++round) {
+            std::vector<ECPoint<LongInt>> points;
+            std::vector<LongInt> scalars;
+            ECPoint<LongInt> expected;
+            for (size_t i = 0; i < k; ++i) {
+                ECPoint<LongInt> Q = P.Power(LongInt(static_cast<int64_t>(gen() % 12)));
+                if (i % 5 == 4) {
+                    Q = points[i - 1].GetInverse();
+                }
+                LongInt n = LongInt(static_cast<int64_t>(gen() >> (gen() % 64)));
+                if (round == 1) {
+                    n = n * LongInt(static_cast<int64_t>(gen() >> 2));
+                } else if (round == 2 && i % 3 == 0) {
+                    n = LongInt(static_cast<int64_t>(i) - 1);
+                }
+                points.push_back(Q);
+                scalars.push_back(n);
+                expected += Q.Power(n);
+            }
+            ASSERT_EQ(ECPoint<LongInt>::MultiScalarMul(points, scalars), expected) << k;
+        }
+    }
+
+    EllipticCurve<int64_t> ec_small(345, 717, 1297, 1246);
+    ECPoint<int64_t>::SetEllipticCurve(ec_small);
+    ECPoint<int64_t> Q(418, 15);
+    ECPoint<int64_t> R(139, 53);
+    for (int64_t a = 0; a < 60; ++a) {
+        for (int64_t b = 0; b < 60; ++b) {
+            ASSERT_EQ(ECPoint<int64_t>::MultiScalarMul({Q, R}, {a * 101, b * 37}),
+                      Q.Power(a * 101) + R.Power(b * 37));
+        }
+    }
+    EXPECT_EQ(ECPoint<int64_t>::MultiScalarMul({Q, Q}, {5, 7}), Q.Power(12));
+    EXPECT_EQ(ECPoint<int64_t>::MultiScalarMul({Q, Q.GetInverse()}, {9, 9}), ECPoint<int64_t>());
+}
+
+TEST(EllipticCurvePoint, LongIntNoNetAllocations) {
+    GmpAllocationCounter counter;
+    EllipticCurve<LongInt> ec(7, 13, 97, 112);
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(13, 19);
+    ECPoint<LongInt> Q(92, 12);
+    ECPoint<LongInt> R = P;
+    for (int i = 0; i < 10; ++i) {
+        R += Q;
+        R += R;
+    }
+    int64_t steady = GmpAllocationCounter::live;
+    for (int i = 0; i < 1000; ++i) {
+        R += Q;
+        EXPECT_EQ(GmpAllocationCounter::live, steady);
+        R += R;
+        EXPECT_EQ(GmpAllocationCounter::live, steady);
+    }
+}
+
+TEST(EllipticCurvePoint, BatchAdd) {
+    EllipticCurve<int64_t> ec(345, 717, 1297, 1246);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    ECPoint<int64_t> P(139, 53);
+    ECPoint<int64_t> Q(418, 15);
+    std::vector<ECPoint<int64_t>> points{P, P, Q, P, ECPoint<int64_t>(), P.Power(5), Q};
+    std::vector<ECPoint<int64_t>> addends{Q, P, P.GetInverse(), ECPoint<int64_t>(), Q, P, Q};
+    std::vector<ECPoint<int64_t>> expected;
+    for (size_t i = 0; i < points.size(); ++i) {
+        expected.push_back(points[i] + addends[i]);
+    }
+    ECPoint<int64_t>::BatchAdd(points, addends);
+    EXPECT_EQ(points, expected);
+}
+
+TEST(EllipticCurvePoint, Partition) {
+    EllipticCurve<int64_t> ec(345, 717, 1297, 1246);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    ECPoint<int64_t> P(139, 53);
+    std::vector<size_t> counts(4);
+    size_t distinguished = 0;
+    for (int i = 1; i <= 1000; ++i) {
+        ECPoint<int64_t> Q = P.Power(i);
+        auto part = Q.Partition(4, 2);
+        auto inv = Q.GetInverse().Partition(4, 2);
+        EXPECT_EQ(part.index, inv.index);
+        EXPECT_EQ(part.distinguished, inv.distinguished);
+        // x < 2^11 leaves at most 9 bits above the partition, all of them have to be zero from
+        // 9 dp_bits on, also past the width of the limb
+        EXPECT_EQ(Q.Partition(4, 64).distinguished, Q.Partition(4, 12).distinguished);
+        EXPECT_EQ(Q.Partition(4, 100).distinguished, Q.Partition(4, 12).distinguished);
+        ++counts[part.index];
+        distinguished += part.distinguished;
+    }
+    for (size_t c : counts) {
+        EXPECT_GT(c, 150u);
+    }
+    EXPECT_GT(distinguished, 150u);
+    EXPECT_LT(distinguished, 350u);
+}
+
+TEST(EllipticCurvePoint, WideHash) {
+    // x coordinates that agree in the low 64 bits, hashing does not need points on the curve
+    LongInt p("170141183460469231731687303715884105727");
+    EllipticCurve<LongInt> ec(LongInt(0), LongInt(2), p, LongInt(1));
+    ECPoint<LongInt>::SetEllipticCurve(ec);
+    ECPoint<LongInt> P(LongInt(5), LongInt(7));
+    ECPoint<LongInt> Q(LongInt("18446744073709551621"), LongInt(7));
+    auto hash = std::hash<ECPoint<LongInt>>{};
+    EXPECT_NE(hash(P), hash(Q));
+    EXPECT_EQ(hash(P), hash(ECPoint<LongInt>(LongInt(5), LongInt(7))));
+}
+
+TEST(FieldLanes, MatchesMontgomery) {
+    std::mt19937_64 gen(7);
+    // the largest prime is 2^62 - 57
+    std::vector<int64_t> primes{1099511627791, 72057594037928017, 4611686018427387847};
+    for (auto p : primes) {
+        Montgomery<int64_t> mont;
+        mont.Init(p);
+        for (auto level : {SimdLevel::kScalar, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+            FieldLanes lanes(p, level);
+            EXPECT_LE(lanes.Level(), DetectSimdLevel());
+            size_t n = 37;  // tails for both vector widths
+            std::vector<uint64_t> a(n);
+            std::vector<uint64_t> b(n);
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = gen() % p;
+                b[i] = i % 5 == 0 ? a[i] : gen() % p;
+            }
+            a[1] = 0;
+            b[2] = p - 1;
+            std::vector<uint64_t> sum(n);
+            std::vector<uint64_t> diff(n);
+            std::vector<uint64_t> prod(n);
+            lanes.Add(a.data(), b.data(), sum.data(), n);
+            lanes.Sub(a.data(), b.data(), diff.data(), n);
+            lanes.Mul(a.data(), b.data(), prod.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                EXPECT_EQ(sum[i], (a[i] + b[i]) % p);
+                EXPECT_EQ(diff[i], (a[i] + p - b[i]) % p);
+                EXPECT_EQ(prod[i], static_cast<uint64_t>(mont.Mul(a[i], b[i])));
+            }
+            // in place
+            std::vector<uint64_t> square = a;
+            lanes.Mul(square.data(), square.data(), square.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                EXPECT_EQ(square[i], static_cast<uint64_t>(mont.Mul(a[i], a[i])));
+            }
+            EXPECT_EQ(lanes.FromMont(lanes.ToMont(12345)), 12345u);
+            uint64_t x = lanes.ToMont(987654321);
+            EXPECT_EQ(lanes.MulOne(x, lanes.Inverse(x)), lanes.ToMont(1));
+        }
+    }
+}
+
+TEST(PointLanes, MatchesBatchAdd) {
+    EllipticCurve<int64_t> ec(345, 717, 1297, 1246);
+    ECPoint<int64_t>::SetEllipticCurve(ec);
+    CurveContext<int64_t> ctx(ec);
+    ECPoint<int64_t> P = ctx.Point(139, 53);
+    ECPoint<int64_t> Q = ctx.Point(418, 15);
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int64_t> scalar(0, 20);
+    std::vector<ECPoint<int64_t>> points{P, P, Q, P, ECPoint<int64_t>(ctx)};
+    std::vector<ECPoint<int64_t>> addends{Q, P, P.GetInverse(), ECPoint<int64_t>(ctx), Q};
+    // small multiples make equal and opposite lanes likely
+    while (points.size() < 43) {
+        points.push_back(P.Power(scalar(gen)));
+        addends.push_back(P.Power(scalar(gen)));
+    }
+    for (auto level : {SimdLevel::kScalar, SimdLevel::kAvx2, SimdLevel::kAvx512}) {
+        PointLanes lanes(ctx, level);
+        PointLanes lane_addends(ctx, level);
+        lanes.Assign(points);
+        lane_addends.Assign(addends);
+        std::vector<ECPoint<int64_t>> expected = points;
+        for (int step = 0; step < 5; ++step) {
+            ECPoint<int64_t>::BatchAdd(expected, addends);
+            lanes.Add(lane_addends);
+            EXPECT_EQ(lanes.Points(), expected);
+        }
+    }
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
 
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/long_int.hpp>
+
 template <class Int>
 Int GCD(Int a, Int b) {
     if (b < 0) {
@@ -76,4 +80,46 @@ Int SolveEquation(Int A, Int B, Int n) {
         n = -n;
     }
     return (ans + n) % n;
-}
\ No newline at end of file
+}
+
+// a^-1 mod n for 0 <= a < n and gcd(a, n) = 1; the overloads for int64_t, LongInt and FixedInt
+// build no ExtendedEuclideanAlgorithm tuple and return 0 for a non-invertible a
+template <class Int>
+Int ModularInverse(const Int& a, const Int& n) {
+    return SolveEquation<Int>(Int{1}, a, n);
+}
+
+// |s0|, |s1| <= n / 2 throughout, so the coefficients never overflow; hardware division beats a
+// binary GCD on 64-bit operands
+inline int64_t ModularInverse(int64_t a, int64_t n) {
+    int64_t r0 = n;
+    int64_t r1 = a;
+    int64_t s0 = 0;
+    int64_t s1 = 1;
+    while (r1 != 0) {
+        int64_t q = r0 / r1;
+        int64_t r = r0 - q * r1;
+        r0 = r1;
+        r1 = r;
+        int64_t s = s0 - q * s1;
+        s0 = s1;
+        s1 = s;
+    }
+    if (r0 != 1) {
+        return 0;
+    }
+    return s0 < 0 ? s0 + n : s0;
+}
+
+inline LongInt ModularInverse(const LongInt& a, const LongInt& n) {
+    return a.InverseMod(n);
+}
+
+// FixedInt division is bit-serial, the binary algorithm needs an odd modulus
+template <size_t N>
+FixedInt<N> ModularInverse(const FixedInt<N>& a, const FixedInt<N>& n) {
+    if (n.Limb(0) & 1) {
+        return a.InverseMod(n);
+    }
+    return SolveEquation<FixedInt<N>>(FixedInt<N>{1}, a, n);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <extended_euclidean/extended_euclidean.hpp>
+#include <long_arithmetic/fixed_int.hpp>
 #include <long_arithmetic/long_int.hpp>
 
 #include <vector>
@@ -125,4 +126,29 @@ TEST(TestSolveEquation, LongInt) {
         LongInt res = SolveEquation<LongInt>(a, b, n);
         EXPECT_TRUE((b * res - a) % n == 0);
     }
-}
\ No newline at end of file
+}
+
+TEST(TestModularInverse, AllIntTypes) {
+    std::vector<int64_t> moduli{2, 9, 97, 1000, 1099511627791, 4611686018427387847};
+    for (int64_t n : moduli) {
+        for (int64_t a : {int64_t{0}, int64_t{1}, int64_t{3}, n / 2, n / 3 + 1, n - 1}) {
+            bool invertible = GCD(a, n) == 1;
+            int64_t inv = ModularInverse(a, n);
+            if (!invertible) {
+                EXPECT_EQ(inv, 0);
+                EXPECT_EQ(ModularInverse(LongInt(a), LongInt(n)), LongInt(0));
+                continue;
+            }
+            EXPECT_EQ((LongInt(a) * LongInt(inv)) % LongInt(n), LongInt(1 % n));
+            EXPECT_EQ(ModularInverse(LongInt(a), LongInt(n)), LongInt(inv));
+            EXPECT_EQ(ModularInverse(FixedInt<2>(a), FixedInt<2>(n)), FixedInt<2>(inv));
+        }
+    }
+    // 2^127 - 1
+    FixedInt<4> p("170141183460469231731687303715884105727");
+    FixedInt<4> a("12345678901234567890123456789");
+    FixedInt<4> inv = ModularInverse(a, p);
+    EXPECT_EQ((a * inv) % p, FixedInt<4>(1));
+    EXPECT_EQ(inv, SolveEquation<FixedInt<4>>(FixedInt<4>(1), a, p));
+    EXPECT_EQ(ModularInverse(FixedInt<4>(0), p), FixedInt<4>(0));
+}
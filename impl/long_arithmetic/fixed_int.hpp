@@ -0,0 +1,439 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// signed fixed-width integer of N 64-bit limbs stored in two's complement on the stack,
+// exposes the same interface as LongInt; division truncates toward zero as for built-in integers
+template <size_t N>
+class FixedInt {
+    static_assert(N > 0, "FixedInt needs at least one limb");
+
+public:
+    FixedInt() : limbs_{} {
+    }
+
+    FixedInt(int64_t v) {
+        limbs_[0] = static_cast<uint64_t>(v);
+        for (size_t i = 1; i < N; ++i) {
+            limbs_[i] = (v < 0) ? ~uint64_t{0} : 0;
+        }
+    }
+
+    FixedInt(const std::string& str);
+
+    int64_t NarrowToInt() const {
+        return static_cast<int64_t>(limbs_[0]);
+    }
+
+    // i-th 64-bit limb of the two's complement representation, least significant first
+    uint64_t Limb(size_t i) const {
+        return limbs_[i];
+    }
+
+    void SetLimb(size_t i, uint64_t v) {
+        limbs_[i] = v;
+    }
+
+    // value of count <= N 64-bit limbs, least significant first, the rest zero
+    static FixedInt FromLimbs(const uint64_t* limbs, size_t count) {
+        FixedInt res;
+        for (size_t i = 0; i < count; ++i) {
+            res.limbs_[i] = limbs[i];
+        }
+        return res;
+    }
+
+    bool IsNegative() const {
+        return static_cast<int64_t>(limbs_[N - 1]) < 0;
+    }
+
+    // number of significant bits of a non-negative value, 0 for zero
+    size_t BitLength() const {
+        for (size_t i = N; i-- > 0;) {
+            if (limbs_[i] != 0) {
+                return 64 * i + 64 - __builtin_clzll(limbs_[i]);
+            }
+        }
+        return 0;
+    }
+
+    // this^-1 mod n by the binary extended Euclidean algorithm, for odd n > 0 and 0 <= this < n;
+    // shifts and subtractions only, no division. 0 when gcd(this, n) != 1
+    FixedInt InverseMod(const FixedInt& n) const;
+
+    // combines all N limbs, unlike NarrowToInt() it sees values wider than 64 bits
+    size_t Hash() const {
+        size_t h = N;
+        for (uint64_t limb : limbs_) {
+            h ^= limb + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+
+    FixedInt operator-() const;
+    FixedInt& operator+=(const FixedInt& other);
+    FixedInt& operator-=(const FixedInt& other);
+    FixedInt& operator*=(const FixedInt& other);
+    FixedInt& operator/=(const FixedInt& other);
+    FixedInt& operator%=(const FixedInt& other);
+
+    FixedInt operator+(const FixedInt& other) const;
+    FixedInt operator-(const FixedInt& other) const;
+    FixedInt operator*(const FixedInt& other) const;
+    FixedInt operator/(const FixedInt& other) const;
+    FixedInt operator%(const FixedInt& other) const;
+
+    bool operator==(const FixedInt& other) const;
+    bool operator!=(const FixedInt& other) const;
+    bool operator<(const FixedInt& other) const;
+    bool operator==(const int& v) const;
+    bool operator!=(const int& v) const;
+    bool operator<(const int& v) const;
+    bool operator<=(const int& v) const;
+    bool operator>(const int& v) const;
+    bool operator>=(const int& v) const;
+
+private:
+    using Limbs = std::array<uint64_t, N>;
+
+    static void Negate(Limbs& v);
+    static int CompareMagnitude(const Limbs& a, const Limbs& b);
+    static void DivModMagnitude(const Limbs& a, const Limbs& b, Limbs& q, Limbs& r);
+    // returns the carry out and the borrow out of the unsigned operation
+    static uint64_t AddMagnitude(Limbs& a, const Limbs& b);
+    static uint64_t SubMagnitude(Limbs& a, const Limbs& b);
+
+    Limbs limbs_;
+};
+
+template <size_t N>
+FixedInt<N>::FixedInt(const std::string& str) : limbs_{} {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < str.size() && (str[pos] == '-' || str[pos] == '+')) {
+        negative = (str[pos] == '-');
+        ++pos;
+    }
+    const FixedInt ten(10);
+    for (; pos < str.size(); ++pos) {
+        *this *= ten;
+        *this += FixedInt(str[pos] - '0');
+    }
+    if (negative) {
+        Negate(limbs_);
+    }
+}
+
+template <size_t N>
+void FixedInt<N>::Negate(Limbs& v) {
+    uint64_t carry = 1;
+    for (size_t i = 0; i < N; ++i) {
+        v[i] = ~v[i] + carry;
+        carry = (carry && v[i] == 0) ? 1 : 0;
+    }
+}
+
+template <size_t N>
+int FixedInt<N>::CompareMagnitude(const Limbs& a, const Limbs& b) {
+    for (size_t i = N; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// schoolbook division of unsigned magnitudes, single-limb divisors take the fast path
+template <size_t N>
+void FixedInt<N>::DivModMagnitude(const Limbs& a, const Limbs& b, Limbs& q, Limbs& r) {
+    q = Limbs{};
+    r = Limbs{};
+    bool single_limb = true;
+    for (size_t i = 1; i < N; ++i) {
+        single_limb = single_limb && b[i] == 0;
+    }
+    if (single_limb) {
+        unsigned __int128 rem = 0;
+        for (size_t i = N; i-- > 0;) {
+            unsigned __int128 cur = (rem << 64) | a[i];
+            q[i] = static_cast<uint64_t>(cur / b[0]);
+            rem = cur % b[0];
+        }
+        r[0] = static_cast<uint64_t>(rem);
+        return;
+    }
+    for (size_t bit = 64 * N; bit-- > 0;) {
+        for (size_t i = N; i-- > 1;) {
+            r[i] = (r[i] << 1) | (r[i - 1] >> 63);
+        }
+        r[0] = (r[0] << 1) | ((a[bit / 64] >> (bit % 64)) & 1);
+        if (CompareMagnitude(r, b) >= 0) {
+            uint64_t borrow = 0;
+            for (size_t i = 0; i < N; ++i) {
+                uint64_t d = r[i] - b[i] - borrow;
+                borrow = (r[i] < b[i] || (r[i] == b[i] && borrow)) ? 1 : 0;
+                r[i] = d;
+            }
+            q[bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+    }
+}
+
+template <size_t N>
+uint64_t FixedInt<N>::AddMagnitude(Limbs& a, const Limbs& b) {
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < N; ++i) {
+        carry += static_cast<unsigned __int128>(a[i]) + b[i];
+        a[i] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+    return static_cast<uint64_t>(carry);
+}
+
+template <size_t N>
+uint64_t FixedInt<N>::SubMagnitude(Limbs& a, const Limbs& b) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < N; ++i) {
+        uint64_t d = a[i] - b[i] - borrow;
+        borrow = (a[i] < b[i] || (a[i] == b[i] && borrow)) ? 1 : 0;
+        a[i] = d;
+    }
+    return borrow;
+}
+
+// x1 * this = u and x2 * this = v (mod n) hold throughout, halving an even u halves x1 mod n
+template <size_t N>
+FixedInt<N> FixedInt<N>::InverseMod(const FixedInt& n) const {
+    const Limbs& p = n.limbs_;
+    Limbs u = limbs_;
+    Limbs v = p;
+    Limbs x1{1};
+    Limbs x2{};
+    // (n + 1) / 2, the inverse of 2
+    Limbs half = p;
+    for (size_t i = 0; i < N; ++i) {
+        half[i] = (p[i] >> 1) | (i + 1 < N ? p[i + 1] << 63 : 0);
+    }
+    AddMagnitude(half, Limbs{1});
+    auto is_one = [](const Limbs& a) {
+        if (a[0] != 1) {
+            return false;
+        }
+        for (size_t i = 1; i < N; ++i) {
+            if (a[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto halve = [&half](Limbs& a, Limbs& x) {
+        for (size_t i = 0; i < N; ++i) {
+            a[i] = (a[i] >> 1) | (i + 1 < N ? a[i + 1] << 63 : 0);
+        }
+        bool odd = x[0] & 1;
+        for (size_t i = 0; i < N; ++i) {
+            x[i] = (x[i] >> 1) | (i + 1 < N ? x[i + 1] << 63 : 0);
+        }
+        if (odd) {
+            AddMagnitude(x, half);
+        }
+    };
+    while (!is_one(u) && !is_one(v)) {
+        if (CompareMagnitude(u, Limbs{}) == 0) {
+            return FixedInt();
+        }
+        while ((u[0] & 1) == 0) {
+            halve(u, x1);
+        }
+        while ((v[0] & 1) == 0) {
+            halve(v, x2);
+        }
+        if (CompareMagnitude(u, v) >= 0) {
+            SubMagnitude(u, v);
+            if (SubMagnitude(x1, x2)) {
+                AddMagnitude(x1, p);
+            }
+        } else {
+            SubMagnitude(v, u);
+            if (SubMagnitude(x2, x1)) {
+                AddMagnitude(x2, p);
+            }
+        }
+    }
+    FixedInt res;
+    res.limbs_ = is_one(u) ? x1 : x2;
+    return res;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator-() const {
+    FixedInt res = *this;
+    Negate(res.limbs_);
+    return res;
+}
+
+template <size_t N>
+FixedInt<N>& FixedInt<N>::operator+=(const FixedInt& other) {
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < N; ++i) {
+        carry += static_cast<unsigned __int128>(limbs_[i]) + other.limbs_[i];
+        limbs_[i] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+    return *this;
+}
+
+template <size_t N>
+FixedInt<N>& FixedInt<N>::operator-=(const FixedInt& other) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < N; ++i) {
+        uint64_t d = limbs_[i] - other.limbs_[i] - borrow;
+        borrow = (limbs_[i] < other.limbs_[i] || (limbs_[i] == other.limbs_[i] && borrow)) ? 1 : 0;
+        limbs_[i] = d;
+    }
+    return *this;
+}
+
+// the low N limbs of the product are the same for signed and unsigned operands
+template <size_t N>
+FixedInt<N>& FixedInt<N>::operator*=(const FixedInt& other) {
+    Limbs res{};
+    for (size_t i = 0; i < N; ++i) {
+        if (limbs_[i] == 0) {
+            continue;
+        }
+        uint64_t carry = 0;
+        for (size_t j = 0; i + j < N; ++j) {
+            unsigned __int128 cur = static_cast<unsigned __int128>(limbs_[i]) * other.limbs_[j] +
+                                    res[i + j] + carry;
+            res[i + j] = static_cast<uint64_t>(cur);
+            carry = static_cast<uint64_t>(cur >> 64);
+        }
+    }
+    limbs_ = res;
+    return *this;
+}
+
+template <size_t N>
+FixedInt<N>& FixedInt<N>::operator/=(const FixedInt& other) {
+    bool negative = IsNegative() != other.IsNegative();
+    Limbs a = limbs_;
+    Limbs b = other.limbs_;
+    if (IsNegative()) {
+        Negate(a);
+    }
+    if (other.IsNegative()) {
+        Negate(b);
+    }
+    Limbs r;
+    DivModMagnitude(a, b, limbs_, r);
+    if (negative) {
+        Negate(limbs_);
+    }
+    return *this;
+}
+
+template <size_t N>
+FixedInt<N>& FixedInt<N>::operator%=(const FixedInt& other) {
+    bool negative = IsNegative();
+    Limbs a = limbs_;
+    Limbs b = other.limbs_;
+    if (IsNegative()) {
+        Negate(a);
+    }
+    if (other.IsNegative()) {
+        Negate(b);
+    }
+    Limbs q;
+    DivModMagnitude(a, b, q, limbs_);
+    if (negative) {
+        Negate(limbs_);
+    }
+    return *this;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator+(const FixedInt& other) const {
+    FixedInt res = *this;
+    res += other;
+    return res;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator-(const FixedInt& other) const {
+    FixedInt res = *this;
+    res -= other;
+    return res;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator*(const FixedInt& other) const {
+    FixedInt res = *this;
+    res *= other;
+    return res;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator/(const FixedInt& other) const {
+    FixedInt res = *this;
+    res /= other;
+    return res;
+}
+
+template <size_t N>
+FixedInt<N> FixedInt<N>::operator%(const FixedInt& other) const {
+    FixedInt res = *this;
+    res %= other;
+    return res;
+}
+
+template <size_t N>
+bool FixedInt<N>::operator==(const FixedInt& other) const {
+    return limbs_ == other.limbs_;
+}
+
+template <size_t N>
+bool FixedInt<N>::operator!=(const FixedInt& other) const {
+    return !(this->operator==(other));
+}
+
+template <size_t N>
+bool FixedInt<N>::operator<(const FixedInt& other) const {
+    if (IsNegative() != other.IsNegative()) {
+        return IsNegative();
+    }
+    return CompareMagnitude(limbs_, other.limbs_) < 0;
+}
+
+template <size_t N>
+bool FixedInt<N>::operator==(const int& v) const {
+    return this->operator==(FixedInt(v));
+}
+
+template <size_t N>
+bool FixedInt<N>::operator!=(const int& v) const {
+    return !this->operator==(v);
+}
+
+template <size_t N>
+bool FixedInt<N>::operator<(const int& v) const {
+    return this->operator<(FixedInt(v));
+}
+
+template <size_t N>
+bool FixedInt<N>::operator<=(const int& v) const {
+    return this->operator<(v) || this->operator==(v);
+}
+
+template <size_t N>
+bool FixedInt<N>::operator>(const int& v) const {
+    return !this->operator<=(v);
+}
+
+template <size_t N>
+bool FixedInt<N>::operator>=(const int& v) const {
+    return !this->operator<(v);
+}
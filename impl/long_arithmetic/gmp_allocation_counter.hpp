@@ -0,0 +1,50 @@
+#pragma once
+
+#include <gmp.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+// test helper: routes GMP heap memory through counting hooks while alive. allocations counts
+// allocations and reallocations, live the allocations not freed yet
+class GmpAllocationCounter {
+public:
+    GmpAllocationCounter() {
+        mp_get_memory_functions(&alloc_, &realloc_, &free_);
+        allocations = 0;
+        live = 0;
+        mp_set_memory_functions(&Allocate, &Reallocate, &Free);
+    }
+
+    ~GmpAllocationCounter() {
+        mp_set_memory_functions(alloc_, realloc_, free_);
+    }
+
+    GmpAllocationCounter(const GmpAllocationCounter&) = delete;
+    GmpAllocationCounter& operator=(const GmpAllocationCounter&) = delete;
+
+    static inline int64_t allocations = 0;
+    static inline int64_t live = 0;
+
+private:
+    static void* Allocate(size_t size) {
+        ++allocations;
+        ++live;
+        return std::malloc(size);
+    }
+
+    static void* Reallocate(void* ptr, size_t, size_t size) {
+        ++allocations;
+        return std::realloc(ptr, size);
+    }
+
+    static void Free(void* ptr, size_t) {
+        --live;
+        std::free(ptr);
+    }
+
+    void* (*alloc_)(size_t);
+    void* (*realloc_)(void*, size_t, size_t);
+    void (*free_)(void*, size_t);
+};
@@ -1,27 +1,27 @@
 #include "long_int.hpp"
 
 LongInt& LongInt::operator+=(const LongInt& other) {
-    *this = (*this + other);
+    mpz_add(val_, val_, other.val_);
     return *this;
 }
 
 LongInt& LongInt::operator-=(const LongInt& other) {
-    *this = (*this - other);
+    mpz_sub(val_, val_, other.val_);
     return *this;
 }
 
 LongInt& LongInt::operator*=(const LongInt& other) {
-    *this = (*this * other);
+    mpz_mul(val_, val_, other.val_);
     return *this;
 }
 
 LongInt& LongInt::operator/=(const LongInt& other) {
-    *this = (*this / other);
+    mpz_fdiv_q(val_, val_, other.val_);
     return *this;
 }
 
 LongInt& LongInt::operator%=(const LongInt& other) {
-    *this = (*this % other);
+    mpz_mod(val_, val_, other.val_);
     return *this;
 }
 
@@ -50,7 +50,7 @@ LongInt LongInt::operator/(const LongInt& other) const {
 
 LongInt LongInt::operator-() const {
     LongInt res;
-    mpz_sub(res.val_, res.val_, val_);
+    mpz_neg(res.val_, val_);
     return res;
 }
 
@@ -73,7 +73,7 @@ bool LongInt::operator<(const LongInt& other) const {
 }
 
 bool LongInt::operator==(const int& v) const {
-    return mpz_cmp_ui(val_, v) == 0;
+    return mpz_cmp_si(val_, v) == 0;
 }
 
 bool LongInt::operator!=(const int& v) const {
@@ -81,7 +81,7 @@ bool LongInt::operator!=(const int& v) const {
 }
 
 bool LongInt::operator<(const int& v) const {
-    return mpz_cmp_ui(val_, v) < 0;
+    return mpz_cmp_si(val_, v) < 0;
 }
 
 bool LongInt::operator<=(const int& v) const {
@@ -97,6 +97,33 @@ bool LongInt::operator>=(const int& v) const {
 }
 
 LongInt& LongInt::operator=(int64_t v) {
-    mpz_init_set_si(val_, v);
+    mpz_set_si(val_, v);
     return *this;
+}
+
+LongInt LongInt::FromLimbs(const uint64_t* limbs, size_t count) {
+    LongInt res;
+    mpz_import(res.val_, count, -1, sizeof(uint64_t), 0, 0, limbs);
+    return res;
+}
+
+size_t LongInt::BitLength() const {
+    return mpz_sgn(val_) == 0 ? 0 : mpz_sizeinbase(val_, 2);
+}
+
+LongInt LongInt::InverseMod(const LongInt& n) const {
+    LongInt res;
+    if (mpz_invert(res.val_, val_, n.val_) == 0) {
+        mpz_set_ui(res.val_, 0);
+    }
+    return res;
+}
+
+size_t LongInt::Hash() const {
+    size_t h = static_cast<size_t>(val_->_mp_size);
+    for (size_t i = 0; i < mpz_size(val_); ++i) {
+        uint64_t limb = mpz_getlimbn(val_, static_cast<mp_size_t>(i));
+        h ^= limb + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+    }
+    return h;
 }
\ No newline at end of file
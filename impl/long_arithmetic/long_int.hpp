@@ -2,6 +2,8 @@
 
 #include <gmp.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 class LongInt {
@@ -22,24 +24,23 @@ public:
     LongInt& operator=(int64_t v);
 
     LongInt(const LongInt& other) {
-        mpz_init(val_);
         mpz_init_set(val_, other.val_);
     }
 
+    // reuses the limb buffer already owned by this
     LongInt& operator=(const LongInt& other) {
-        mpz_init(val_);
-        mpz_init_set(val_, other.val_);
+        mpz_set(val_, other.val_);
         return *this;
     }
 
-    LongInt(LongInt&& other) {
-        mpz_init(val_);
-        mpz_init_set(val_, other.val_);
+    // steals the limb buffer, other is left as a valid zero that owns no memory
+    LongInt(LongInt&& other) noexcept {
+        *val_ = *other.val_;
+        mpz_init(other.val_);
     }
 
-    LongInt& operator=(LongInt&& other) {
-        mpz_init(val_);
-        mpz_init_set(val_, other.val_);
+    LongInt& operator=(LongInt&& other) noexcept {
+        mpz_swap(val_, other.val_);
         return *this;
     }
 
@@ -51,6 +52,24 @@ public:
         return mpz_get_si(val_);
     }
 
+    // i-th 64-bit limb of the absolute value, least significant first, 0 above the top limb;
+    // reads the mpz buffer directly
+    uint64_t Limb(size_t i) const {
+        return mpz_getlimbn(val_, static_cast<mp_size_t>(i));
+    }
+
+    // non-negative value of count 64-bit limbs, least significant first, through mpz_import
+    static LongInt FromLimbs(const uint64_t* limbs, size_t count);
+
+    // number of significant bits of the absolute value, 0 for zero
+    size_t BitLength() const;
+
+    // this^-1 mod n through mpz_invert, 0 when gcd(this, n) != 1
+    LongInt InverseMod(const LongInt& n) const;
+
+    // combines all limbs and the sign, unlike NarrowToInt() it sees values wider than 64 bits
+    size_t Hash() const;
+
     LongInt operator-() const;
     LongInt& operator+=(const LongInt& other);
     LongInt& operator-=(const LongInt& other);
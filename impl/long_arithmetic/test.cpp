@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <long_arithmetic/fixed_int.hpp>
+#include <long_arithmetic/gmp_allocation_counter.hpp>
 #include <long_arithmetic/long_int.hpp>
 
+#include <utility>
+
 TEST(LongInt, SmallNumbers) {
     LongInt a("12");
     LongInt b("7");
@@ -28,6 +32,23 @@ TEST(LongInt, BigNumbers) {
     EXPECT_EQ(b % a, LongInt("11167535958821309"));
 }
 
+TEST(LongInt, WideHash) {
+    LongInt a("18446744073709551621");  // 2^64 + 5
+    EXPECT_EQ(a.Limb(0), 5u);
+    EXPECT_EQ(a.Limb(1), 1u);
+    EXPECT_EQ(a.Limb(2), 0u);
+    EXPECT_EQ(a.Hash(), LongInt("18446744073709551621").Hash());
+    EXPECT_NE(a.Hash(), LongInt(5).Hash());
+    EXPECT_NE(LongInt(5).Hash(), LongInt(-5).Hash());
+}
+
+TEST(LongInt, FromLimbs) {
+    uint64_t limbs[] = {5, 1, 0};
+    EXPECT_EQ(LongInt::FromLimbs(limbs, 3), LongInt("18446744073709551621"));
+    EXPECT_EQ(LongInt::FromLimbs(limbs, 1), LongInt(5));
+    EXPECT_EQ(LongInt::FromLimbs(limbs, 0), LongInt(0));
+}
+
 TEST(LongInt, Comparison) {
     EXPECT_TRUE(LongInt("0") == 0);
     EXPECT_TRUE(LongInt("12") > 0);
@@ -49,4 +70,116 @@ TEST(LongInt, AssignInt) {
     LongInt b = -2;
 
     EXPECT_EQ(a + a, -b);
-}
\ No newline at end of file
+}
+
+TEST(LongInt, NegativeComparison) {
+    EXPECT_TRUE(LongInt("-5") < -4);
+    EXPECT_TRUE(LongInt("-5") == -5);
+    EXPECT_TRUE(LongInt("-5") > -6);
+}
+
+TEST(LongInt, MoveStealsBuffer) {
+    GmpAllocationCounter counter;
+    LongInt a("72057594037928017");
+    LongInt b("15222514519776677");
+    int64_t before = GmpAllocationCounter::allocations;
+
+    LongInt c = std::move(a);
+    b = std::move(c);
+    EXPECT_EQ(GmpAllocationCounter::allocations, before);
+    EXPECT_EQ(b, LongInt("72057594037928017"));
+}
+
+TEST(LongInt, InPlaceReusesCapacity) {
+    GmpAllocationCounter counter;
+    LongInt a("72057594037928017");
+    LongInt b("15222514519776677");
+    LongInt c("1");
+    c *= a;
+    c *= b;
+    int64_t before = GmpAllocationCounter::allocations;
+
+    c = a;
+    c += b;
+    c -= b;
+    c %= b;
+    c = 42;
+    EXPECT_EQ(GmpAllocationCounter::allocations, before);
+    EXPECT_EQ(c, LongInt("42"));
+}
+
+TEST(FixedInt, SmallNumbers) {
+    FixedInt<2> a("12");
+    FixedInt<2> b("7");
+    EXPECT_EQ(a + b, FixedInt<2>("19"));
+    EXPECT_EQ(a - b, FixedInt<2>("5"));
+    EXPECT_EQ(b - a, FixedInt<2>("-5"));
+    EXPECT_EQ(a * b, FixedInt<2>("84"));
+    EXPECT_EQ(a / b, FixedInt<2>("1"));
+    EXPECT_EQ(a % b, FixedInt<2>("5"));
+    EXPECT_EQ(b % a, FixedInt<2>("7"));
+}
+
+TEST(FixedInt, BigNumbers) {
+    FixedInt<2> a("15222514519776677");
+    FixedInt<2> b("72057594037928017");
+
+    EXPECT_EQ(a + b, FixedInt<2>("87280108557704694"));
+    EXPECT_EQ(a - b, FixedInt<2>("-56835079518151340"));
+    EXPECT_EQ(b - a, FixedInt<2>("56835079518151340"));
+    EXPECT_EQ(a * b, FixedInt<2>("1096897771502532551423974641459509"));
+    EXPECT_EQ(a / b, FixedInt<2>("0"));
+    EXPECT_EQ(b / a, FixedInt<2>("4"));
+    EXPECT_EQ(a % b, FixedInt<2>("15222514519776677"));
+    EXPECT_EQ(b % a, FixedInt<2>("11167535958821309"));
+}
+
+TEST(FixedInt, MultiLimbDivisor) {
+    FixedInt<4> a("1096897771502532551423974641459509");
+    FixedInt<4> b("87280108557704694");
+    FixedInt<4> c = a * b;
+    EXPECT_EQ(c, FixedInt<4>("95737356573445399366901897312794264825907180235246"));
+    EXPECT_EQ(c / a, b);
+    EXPECT_EQ(c % a, FixedInt<4>("0"));
+    EXPECT_EQ((c + FixedInt<4>(5)) % a, FixedInt<4>("5"));
+    EXPECT_EQ((-c) / a, -b);
+    EXPECT_EQ((-c - FixedInt<4>(5)) % a, FixedInt<4>("-5"));
+}
+
+TEST(FixedInt, WideHash) {
+    FixedInt<2> a("18446744073709551621");  // 2^64 + 5
+    EXPECT_EQ(a.Hash(), FixedInt<2>("18446744073709551621").Hash());
+    EXPECT_NE(a.Hash(), FixedInt<2>(5).Hash());
+}
+
+TEST(FixedInt, FromLimbs) {
+    uint64_t limbs[] = {5, 1};
+    EXPECT_EQ(FixedInt<2>::FromLimbs(limbs, 2), FixedInt<2>("18446744073709551621"));
+    EXPECT_EQ(FixedInt<2>::FromLimbs(limbs, 1), FixedInt<2>(5));
+}
+
+TEST(FixedInt, Comparison) {
+    EXPECT_TRUE(FixedInt<2>("0") == 0);
+    EXPECT_TRUE(FixedInt<2>("12") > 0);
+    EXPECT_TRUE(FixedInt<2>("1") >= 0);
+    EXPECT_TRUE(FixedInt<2>("-1") < 0);
+    EXPECT_TRUE(FixedInt<2>("-4") <= 0);
+    EXPECT_TRUE(FixedInt<2>("3") != 0);
+    EXPECT_TRUE(FixedInt<2>("-72057594037928017") < FixedInt<2>("-5"));
+    EXPECT_TRUE(FixedInt<2>("5") < FixedInt<2>("1096897771502532551423974641459509"));
+}
+
+TEST(FixedInt, UnaryMinus) {
+    FixedInt<2> n("19");
+    FixedInt<2> m = -n;
+    EXPECT_EQ(m, FixedInt<2>("-19"));
+    EXPECT_EQ(n, FixedInt<2>("19"));
+    EXPECT_EQ(m.NarrowToInt(), -19);
+}
+
+TEST(FixedInt, AssignInt) {
+    FixedInt<4> a = 1;
+    FixedInt<4> b = -2;
+
+    EXPECT_EQ(a + a, -b);
+}
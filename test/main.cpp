@@ -4,7 +4,7 @@
 #include <random>
 
 #include <discrete_logarithm/dl_finder.hpp>
-#include <discrete_logarithm/tonelli_shanks.hpp>
+#include <discrete_logarithm/random_points.hpp>
 #include <elliptic_curve/ec_point.hpp>
 #include <elliptic_curve/field.hpp>
 #include <long_arithmetic/long_int.hpp>
@@ -12,25 +12,15 @@
 static std::mt19937 gen(42);
 
 template <class Int>
-ECPoint<Int> GetRandomPoint(const EllipticCurve<Int>& ec, int64_t p) {
-    std::uniform_int_distribution<int64_t> dist(1, p - 1);
-    Int x, y;
-    do {
-        x = Int{dist(gen)};
-        FieldElem<Int> X(x);
-        FieldElem<Int> S = X * X * X + FieldElem(ec.A()) * X + FieldElem(ec.B());
-        y = TonelliShanks(S.GetVal(), ec.Prime());
-    } while (y == Int{-1});
-    assert((y * y) % Int{p} == (x * x * x + ec.A() * x + ec.B()) % Int{p});
-    ECPoint P(x, y);
-    return P;
+ECPoint<Int> GetRandomPoint() {
+    return RandomPoints(ECPoint<Int>().Context(), 1, gen)[0];
 }
 
 void CheckDiscreteLogarithmOnEllipticCurve(int64_t p, int64_t a, int64_t b, int64_t q) {
     EllipticCurve<LongInt> ec(LongInt{a}, LongInt{b}, LongInt{p}, LongInt{q});
     ECPoint<LongInt>::SetEllipticCurve(ec);
-    ECPoint<LongInt> P = GetRandomPoint<LongInt>(ec, p);
-    ECPoint<LongInt> Q = GetRandomPoint<LongInt>(ec, p);
+    ECPoint<LongInt> P = GetRandomPoint<LongInt>();
+    ECPoint<LongInt> Q = GetRandomPoint<LongInt>();
     DiscreteLogarithmFinder<ECPoint<LongInt>, LongInt> dl_finder(P, Q, q);
     auto res = dl_finder.Find();
     assert(P.Power(res) == Q);